@@ -0,0 +1,99 @@
+/**
+ * DFR_Radar: Activity-Classifier.ino
+ *
+ * This example tells apart someone walking through, someone sitting and
+ * moving a little (typing, talking), and someone sitting still, which the
+ * presence bit alone can't.  Five times a second it reads the point cloud
+ * and the presence bit, and a DFR_RadarActivity labels the last 8 frames.
+ *
+ * Whenever the label changes, it prints the new one with the statistics
+ * behind it, and how long the classifier took on this board.  Use those to
+ * tune the thresholds for your room: walk through, sit at the desk, and
+ * leave, and see where the numbers fall.
+ *
+ * The built-in LED is on while someone is walking, e.g. to light a
+ * corridor only for people passing through.
+ */
+
+#include <DFR_Radar.h>
+#include <DFR_RadarActivity.h>
+
+typedef DFR_RadarActivity<8> Activity;
+
+// Serial1 is the hardware UART pins
+DFR_Radar sensor( &Serial1 );
+
+Activity activity;
+
+DFR_RadarPoint points[16];
+
+const char *const labels[] = { "empty", "stationary", "micro-motion", "walking" };
+
+const unsigned long frameInterval = 200;
+unsigned long lastFrame = 0;
+
+uint32_t updates = 0;
+unsigned long updateTime = 0;
+
+void setup()
+{
+  Serial.begin( 9600 );
+
+  // The DFRobot device is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  // Only send the point cloud when asked for it (passive mode)
+  sensor.configBegin();
+  sensor.configureUartPointCloudOutput( true, false, 1501 );
+  sensor.configEnd();
+
+  // Ignore reflections weaker than 10 dB
+  DFR_RadarActivityThresholds thresholds;
+  thresholds.minMagnitude = 100;
+  activity.setThresholds( thresholds );
+
+  // Setup the built-in LED
+  pinMode( LED_BUILTIN, OUTPUT );
+}
+
+void loop()
+{
+  if( millis() - lastFrame < frameInterval )
+    return;
+
+  lastFrame = millis();
+
+  uint8_t count;
+  bool presence;
+  if( !sensor.readPointCloud( points, 16, count ) || !sensor.readPresence( presence ) )
+    return;
+
+  const Activity::Activity previous = activity.getActivity();
+
+  const unsigned long start = micros();
+  const Activity::Activity current = activity.update( points, count, presence );
+  updateTime += micros() - start;
+  updates++;
+
+  digitalWrite( LED_BUILTIN, current == Activity::Walking );
+
+  if( current == previous )
+    return;
+
+  const Activity::Statistics &statistics = activity.getStatistics();
+
+  Serial.print( labels[current] );
+  Serial.print( ": moving in " );
+  Serial.print( statistics.movingFrames );
+  Serial.print( '/' );
+  Serial.print( statistics.frames );
+  Serial.print( " frames, walking speed in " );
+  Serial.print( statistics.walkingFrames );
+  Serial.print( ", average peak " );
+  Serial.print( statistics.peakSpeedSum / statistics.frames );
+  Serial.print( " mm/s, drift " );
+  Serial.print( statistics.drift );
+  Serial.print( " mm (" );
+  Serial.print( float( updateTime ) / updates, 1 );
+  Serial.println( " us/update)" );
+}
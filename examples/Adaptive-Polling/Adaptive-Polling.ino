@@ -0,0 +1,62 @@
+/**
+ * DFR_Radar: Adaptive-Polling.ino
+ * 
+ * This example queries the sensor for presence over serial, but instead of
+ * asking on every pass through `loop()`, it lets a DFR_RadarPoller decide
+ * when another query is worthwhile.  Right after presence changes, it polls
+ * quickly; while nothing changes, it backs off until it only asks every few
+ * seconds.
+ *
+ * The effective sample rate and the current polling interval are printed
+ * whenever presence changes, so you can see the trade-off between detection
+ * latency and UART load.
+ * 
+ * When motion is detected, it will turn on the built-in LED.
+ */
+
+#include <DFR_Radar.h>
+#include <DFR_RadarPoller.h>
+
+// Serial1 is the hardware UART pins
+DFR_Radar sensor( &Serial1 );
+
+// Poll every 50ms right after a change, backing off to every 4 seconds
+DFR_RadarPoller poller( 50, 4000 );
+
+bool lastPresence = false;
+
+void setup()
+{
+  Serial.begin( 9600 );
+  
+  // The DFRobot device is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  // Setup the built-in LED
+  pinMode( LED_BUILTIN, OUTPUT );
+}
+
+void loop()
+{
+  // Only talks to the sensor when it's time to
+  if( !poller.poll( sensor ) )
+    return;
+
+  bool presence = poller.getPresence();
+
+  // If presence == true, turn on the built-in LED.
+  digitalWrite( LED_BUILTIN, presence );
+
+  if( presence == lastPresence )
+    return;
+
+  lastPresence = presence;
+
+  Serial.print( "Presence: " );
+  Serial.print( presence );
+  Serial.print( "  sample rate: " );
+  Serial.print( poller.getSampleRate() );
+  Serial.print( " Hz  interval: " );
+  Serial.print( poller.getInterval() );
+  Serial.println( " ms" );
+}
@@ -0,0 +1,111 @@
+/**
+ * DFR_Radar: Calibration-Sweep.ino
+ *
+ * This example finds the sensitivity, detection range and trigger latency
+ * that suit an installation, instead of a technician trying settings one
+ * by one.  A reference target -- a fan or a motorised reflector, plugged
+ * into a relay on pin 7 and placed where people will be -- is switched on
+ * and off while DFR_RadarCalibration tries all 24 combinations below,
+ * counting false triggers (target off) and missed triggers (target on).
+ * Keep the room empty otherwise.
+ *
+ * Nothing is saved to flash until the end, when only the best profile is
+ * committed.  Each step reports its counts; the built-in LED lights while
+ * the target is on.  With 40 readings a phase, a step takes
+ * about 25 seconds, so the whole sweep takes 10 minutes or less: steps
+ * that can't beat the best so far are cut short.
+ */
+
+#include <DFR_Radar.h>
+#include <DFR_RadarCalibration.h>
+
+typedef DFR_RadarCalibration<DFR_Radar> Calibration;
+
+// Serial1 is the hardware UART pins
+DFR_Radar sensor( &Serial1 );
+
+const uint8_t relayPin = 7;
+
+const uint8_t levels[] = { 3, 5, 7, 9 };
+const Calibration::Range ranges[] = { { 0, 3 }, { 0, 4.5 }, { 0, 6 } };
+const Calibration::Latency latencies[] = { { 0.025, 1 }, { 0.5, 2 } };
+
+void switchTarget( bool on )
+{
+  digitalWrite( relayPin, on );
+  digitalWrite( LED_BUILTIN, on );
+}
+
+Calibration calibration( sensor, switchTarget, levels, 4, ranges, 3, latencies, 2 );
+
+void printProfile( const Calibration::Result &result )
+{
+  Serial.print( "sensitivity " );
+  Serial.print( result.sensitivity );
+  Serial.print( ", range " );
+  Serial.print( result.range.start );
+  Serial.print( '-' );
+  Serial.print( result.range.end );
+  Serial.print( " m, latency " );
+  Serial.print( result.latency.confirmation, 3 );
+  Serial.print( '/' );
+  Serial.print( result.latency.disappearance, 3 );
+  Serial.print( " s" );
+}
+
+void setup()
+{
+  Serial.begin( 9600 );
+
+  // The DFRobot device is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  pinMode( relayPin, OUTPUT );
+  pinMode( LED_BUILTIN, OUTPUT );
+
+  // 40 readings per phase, 4 a second
+  calibration.setWindow( 40, 250 );
+
+  if( !calibration.begin() )
+    Serial.println( "Couldn't configure the sensor" );
+}
+
+void loop()
+{
+  switch( calibration.run() )
+  {
+    case Calibration::Stepped:
+    {
+      const Calibration::Result &result = calibration.getLast();
+
+      Serial.print( calibration.getStep() );
+      Serial.print( '/' );
+      Serial.print( calibration.getStepCount() );
+      Serial.print( ": " );
+      printProfile( result );
+      Serial.print( ": " );
+      Serial.print( result.falseTriggers );
+      Serial.print( " false, " );
+      Serial.print( result.missedTriggers );
+      Serial.println( result.complete ? " missed" : " missed (cut short)" );
+      break;
+    }
+
+    case Calibration::Finished:
+      Serial.print( "Saved " );
+      printProfile( calibration.getBest() );
+      Serial.print( " after " );
+      Serial.print( calibration.getCommandCount() );
+      Serial.print( " commands, " );
+      Serial.print( calibration.getReconfigurationTime() );
+      Serial.println( " ms reconfiguring" );
+      break;
+
+    case Calibration::Failed:
+      Serial.println( "Calibration failed; nothing was saved" );
+      break;
+
+    default:
+      break;
+  }
+}
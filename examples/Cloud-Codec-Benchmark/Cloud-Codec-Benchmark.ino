@@ -0,0 +1,125 @@
+/**
+ * DFR_Radar: Cloud-Codec-Benchmark.ino
+ *
+ * This example measures how small DFR_RadarCloudEncoder makes point cloud
+ * frames, compared with the $JYRPO lines the sensor sends, and how long
+ * encoding and decoding a frame take on your board.
+ *
+ * No sensor is needed: the frames are made up, but move like real ones --
+ * someone walking back and forth (two points, since a body reflects from
+ * more than one place), two pieces of furniture, and a stray point now and
+ * then -- with a little noise on every field.  They come from a fixed
+ * pseudo-random sequence, so every board encodes the same frames and the
+ * results can be compared.
+ *
+ * Points are quantised to 1 cm, 1 cm/s and 0.5 dB, with a keyframe every
+ * 16 frames.
+ */
+
+#include <DFR_RadarCloudCodec.h>
+
+const uint16_t frameCount = 500;
+
+DFR_RadarCloudEncoder<8> encoder( 10, 10, 5, 16 );
+DFR_RadarCloudDecoder<8> decoder;
+
+uint32_t seed;
+
+// xorshift32: the same sequence on every board, unlike random()
+int16_t noise( int16_t amplitude )
+{
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return int16_t( seed % ( 2 * amplitude + 1 ) ) - amplitude;
+}
+
+uint8_t makeFrame( uint16_t frame, DFR_RadarPoint points[] )
+{
+  // Walks between 1 and 5 m at 0.5 m/s, measured five times a second
+  const uint16_t lap = frame % 80;
+  const uint16_t range = lap < 40 ? 1000 + lap * 100 : 9000 - lap * 100;
+  const int16_t velocity = lap < 40 ? 500 : -500;
+
+  uint8_t count = 0;
+  points[count++] = { uint16_t( range + noise( 15 ) ), int16_t( velocity + noise( 20 ) ), uint16_t( 380 + noise( 10 ) ) };
+  points[count++] = { uint16_t( range + 150 + noise( 15 ) ), int16_t( velocity + noise( 20 ) ), uint16_t( 300 + noise( 10 ) ) };
+  points[count++] = { uint16_t( 2200 + noise( 5 ) ), int16_t( noise( 10 ) ), uint16_t( 250 + noise( 5 ) ) };
+  points[count++] = { uint16_t( 4100 + noise( 5 ) ), int16_t( noise( 10 ) ), uint16_t( 200 + noise( 5 ) ) };
+
+  if( noise( 2 ) == 0 )
+    points[count++] = { uint16_t( 3000 + noise( 3000 ) ), noise( 1000 ), uint16_t( 150 + noise( 100 ) ) };
+
+  return count;
+}
+
+// The length of the lines the sensor would send for a frame, e.g. "$JYRPO,4,1,1.524,38.6,-0.310*\r\n"
+size_t textLength( const DFR_RadarPoint points[], uint8_t count )
+{
+  char line[48];
+  size_t length = 0;
+
+  for( uint8_t i = 0; i < count; i++ )
+  {
+    const uint16_t speed = abs( points[i].velocity );
+    length += snprintf( line, sizeof( line ), "$JYRPO,%u,%u,%u.%03u,%u.%u,%s%u.%03u*\r\n", count, i + 1,
+                        points[i].range / 1000, points[i].range % 1000, points[i].magnitude / 10, points[i].magnitude % 10,
+                        points[i].velocity < 0 ? "-" : "", speed / 1000, speed % 1000 );
+  }
+
+  return length;
+}
+
+void setup()
+{
+  Serial.begin( 9600 );
+
+  while( !Serial )
+    ;
+}
+
+void loop()
+{
+  DFR_RadarPoint points[8];
+  uint8_t frame[DFR_RadarCloudFormat::maxFrameLength( 8 )];
+
+  uint32_t textBytes = 0;
+  uint32_t encodedBytes = 0;
+  unsigned long encoding = 0;
+  unsigned long decoding = 0;
+  uint16_t decoded = 0;
+
+  seed = 2463534242UL;
+
+  for( uint16_t i = 0; i < frameCount; i++ )
+  {
+    const uint8_t count = makeFrame( i, points );
+    textBytes += textLength( points, count );
+
+    unsigned long start = micros();
+    const size_t length = encoder.encode( points, count, frame, sizeof( frame ) );
+    encoding += micros() - start;
+    encodedBytes += length;
+
+    uint8_t received;
+    start = micros();
+    decoded += decoder.decode( frame, length, points, 8, received );
+    decoding += micros() - start;
+  }
+
+  Serial.print( "Bytes/frame (text): " );
+  Serial.println( float( textBytes ) / frameCount, 1 );
+  Serial.print( "Bytes/frame (encoded): " );
+  Serial.println( float( encodedBytes ) / frameCount, 2 );
+  Serial.print( "Compression ratio: " );
+  Serial.println( float( textBytes ) / encodedBytes, 1 );
+  Serial.print( "Encode us/frame: " );
+  Serial.println( float( encoding ) / frameCount, 1 );
+  Serial.print( "Decode us/frame: " );
+  Serial.println( float( decoding ) / frameCount, 1 );
+  Serial.print( "Frames decoded: " );
+  Serial.println( decoded );
+  Serial.println();
+
+  delay( 5000 );
+}
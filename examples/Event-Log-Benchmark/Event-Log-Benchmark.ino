@@ -0,0 +1,110 @@
+/**
+ * DFR_Radar: Event-Log-Benchmark.ino
+ * 
+ * This example measures how fast a DFR_RadarEventLog can record events,
+ * and how many bytes of storage each one takes, compared with printing
+ * the same events as lines of text.
+ *
+ * No sensor or SD card is needed: the log's blocks go to a sink that only
+ * counts them, so the result is the cost of encoding and buffering alone.
+ * With a real card, the sink would write each block with a single
+ * `file.write( block, length )`.
+ *
+ * The events are a typical mix: mostly presence changes, with a point
+ * cloud summary every few of them, and a health change and an occupancy
+ * summary now and then.
+ */
+
+#include <DFR_RadarEventLog.h>
+
+const uint16_t iterations = 1000;
+
+uint32_t bytesStored = 0;
+
+// A frame of two points, as `readPointCloud()` would return it
+DFR_RadarPoint frame[2] = { { 1524, -310, 386 }, { 3110, 500, 275 } };
+
+bool countBlock( const uint8_t *block, size_t length, void *context )
+{
+  bytesStored += length;
+  return true;
+}
+
+// One SD sector per block
+DFR_RadarEventLog<512> events( countBlock );
+
+// What each event would cost as a line of text, e.g. "123456,0,presence,1\r\n"
+uint32_t textLength( uint8_t sensor, const char *event, uint8_t value )
+{
+  char line[40];
+  return snprintf( line, sizeof( line ), "%lu,%u,%s,%u\r\n", millis(), sensor, event, value );
+}
+
+// Likewise for a point cloud summary, e.g. "123456,0,points,2,1.524,38.6\r\n"
+uint32_t pointsTextLength( uint8_t sensor )
+{
+  char line[48];
+  return snprintf( line, sizeof( line ), "%lu,%u,points,%u,%u.%03u,%u.%u\r\n", millis(), sensor, 2,
+                   frame[0].range / 1000, frame[0].range % 1000, frame[0].magnitude / 10, frame[0].magnitude % 10 );
+}
+
+void setup()
+{
+  Serial.begin( 9600 );
+
+  while( !Serial )
+    ;
+}
+
+void loop()
+{
+  const uint32_t firstRecord = events.getRecordCount();
+  bytesStored = 0;
+
+  const unsigned long start = micros();
+
+  for( uint16_t i = 0; i < iterations; i++ )
+  {
+    events.logPresence( i & 3, i & 1 );
+
+    if( i % 4 == 0 )
+      events.logPointCloud( i & 3, frame, 2 );
+
+    if( i % 16 == 0 )
+      events.logHealth( i & 3, 0, 1 );
+
+    if( i % 32 == 0 )
+      events.logOccupancy( 0, 0x03, 4, 2 );
+  }
+
+  events.flush();
+
+  const unsigned long elapsed = micros() - start;
+  const uint32_t logged = events.getRecordCount() - firstRecord;
+
+  // The same events as text, for comparison
+  uint32_t textBytes = 0;
+  for( uint16_t i = 0; i < iterations; i++ )
+  {
+    textBytes += textLength( i & 3, "presence", i & 1 );
+
+    if( i % 4 == 0 )
+      textBytes += pointsTextLength( i & 3 );
+
+    if( i % 16 == 0 )
+      textBytes += textLength( i & 3, "health", 1 );
+
+    if( i % 32 == 0 )
+      textBytes += textLength( 0, "occupancy", 2 );
+  }
+
+  Serial.print( "Events/sec: " );
+  Serial.println( logged * 1000000.0 / elapsed, 0 );
+  Serial.print( "Bytes/event (binary, whole blocks): " );
+  Serial.println( float( bytesStored ) / logged, 2 );
+  Serial.print( "Bytes/event (text): " );
+  Serial.println( float( textBytes ) / logged, 2 );
+  Serial.println();
+
+  delay( 5000 );
+}
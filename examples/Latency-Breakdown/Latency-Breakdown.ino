@@ -0,0 +1,117 @@
+/**
+ * DFR_Radar: Latency-Breakdown.ino
+ *
+ * This example measures where the time goes between the sensor detecting
+ * someone and the sketch acting on it.  The sensor pushes its status on
+ * every change, the driver stamps each frame with micros() as its bytes are
+ * read, and a DFR_RadarLatency adds up the stages: how far the UART is
+ * behind the IO pin, the transfer, the parsing and the sketch's own reaction
+ * (switching the built-in LED).
+ *
+ * The IO pin is followed with an interrupt, so its edges are timed to the
+ * microsecond however busy loop() is.  Every 30 seconds it prints each
+ * stage's count, minimum, mean and maximum in microseconds.  Change the
+ * latencies below and compare: the trigger latency delays both outputs
+ * alike, while the output latency only delays the pin, so the edge stage
+ * goes negative.  To see the trigger latency itself, wire a reference
+ * detector (a PIR, or a button pressed on walking in) to the interrupt pin
+ * instead of IO2.
+ */
+
+#include <DFR_Radar.h>
+
+// Serial1 is the hardware UART pins
+DFR_Radar sensor( &Serial1 );
+
+// IO2 from sensor is connected to pin 3 on the Arduino (it must be able to interrupt)
+const int TRIGGER_INPUT = 3;
+
+// In seconds, as for setTriggerLatency() and setOutputLatency()
+const float confirmationDelay = 0.025;
+const float disappearanceDelay = 1;
+const float triggerDelay = 0;
+const float resetDelay = 0;
+
+const unsigned long reportInterval = 30000;
+unsigned long lastReport = 0;
+
+DFR_RadarLatency latency;
+bool presence = false;
+
+volatile unsigned long edgeTime = 0;
+volatile bool edgeSeen = false;
+
+void onEdge()
+{
+  edgeTime = micros();
+  edgeSeen = true;
+}
+
+void setup()
+{
+  Serial.begin( 9600 );
+
+  // The DFRobot device is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  // Setup the built-in LED
+  pinMode( LED_BUILTIN, OUTPUT );
+
+  // Push the status on every change, and only the status
+  sensor.configBegin();
+  sensor.setTriggerLatency( confirmationDelay, disappearanceDelay );
+  sensor.setOutputLatency( triggerDelay, resetDelay );
+  sensor.configureUartPointCloudOutput( false );
+  sensor.configureUartDetectionOutput( true, true, 1501 );
+  sensor.configEnd();
+
+  pinMode( TRIGGER_INPUT, INPUT );
+  attachInterrupt( digitalPinToInterrupt( TRIGGER_INPUT ), onEdge, CHANGE );
+}
+
+void loop()
+{
+  // Copied with interrupts off, as an unsigned long takes more than one instruction on 8-bit boards
+  if( edgeSeen )
+  {
+    noInterrupts();
+    const unsigned long time = edgeTime;
+    edgeSeen = false;
+    interrupts();
+
+    latency.recordEdge( time );
+  }
+
+  // Only the frames that change presence are acted on, and paired with an edge
+  DFR_RadarStatus status;
+  if( sensor.receiveStatus( status ) && status.presence != presence )
+  {
+    presence = status.presence;
+    digitalWrite( LED_BUILTIN, presence );
+    latency.record( status.timing );
+  }
+
+  if( millis() - lastReport < reportInterval )
+    return;
+
+  lastReport = millis();
+
+  for( uint8_t i = 0; i < DFR_RadarLatency::stageCount; i++ )
+  {
+    const DFR_RadarLatency::Stage stage = DFR_RadarLatency::Stage( i );
+    const DFR_RadarLatency::Statistics &statistics = latency.getStatistics( stage );
+
+    Serial.print( DFR_RadarLatency::getStageName( stage ) );
+    Serial.print( ": " );
+    Serial.print( statistics.count );
+    Serial.print( " x, " );
+    Serial.print( statistics.minimum );
+    Serial.print( " / " );
+    Serial.print( statistics.getMean() );
+    Serial.print( " / " );
+    Serial.print( statistics.maximum );
+    Serial.println( " us (min / mean / max)" );
+  }
+
+  Serial.println();
+}
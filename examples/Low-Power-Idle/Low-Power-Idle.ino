@@ -0,0 +1,96 @@
+/**
+ * DFR_Radar: Low-Power-Idle.ino
+ * 
+ * This example queries the sensor for presence once a second, and sleeps
+ * the core the rest of the time: both between queries, and inside the
+ * library while it waits for the sensor to answer (the DFR_RadarSleepIdle
+ * policy, instead of polling the UART at full speed).
+ *
+ * Every 10 seconds it prints the duty cycle, i.e. how much of the time the
+ * core was awake, and an estimate of the average current drawn from it.
+ * For the estimate, fill in your board's figures below (from its datasheet,
+ * or better, measured); the defaults are only rough numbers for a 16MHz AVR.
+ * 
+ * When motion is detected, it will turn on the built-in LED.
+ */
+
+#include <DFR_Radar.h>
+
+// Current drawn while running and while sleeping, in mA
+const float activeCurrent = 15.0;
+const float sleepCurrent = 6.0;
+
+const unsigned long queryInterval = 1000;
+const unsigned long reportInterval = 10000;
+
+// Adds up the time spent asleep, then sleeps just like DFR_RadarSleepIdle
+unsigned long asleep = 0;
+
+struct MeasuredSleepIdle
+{
+  static void wait()
+  {
+    const unsigned long start = micros();
+    DFR_RadarSleepIdle::wait();
+    asleep += micros() - start;
+  }
+};
+
+struct LowPowerTraits : DFR_RadarTraits
+{
+  typedef MeasuredSleepIdle Idle;
+};
+
+// Serial1 is the hardware UART pins
+DFR_RadarT<LowPowerTraits> sensor( &Serial1 );
+
+unsigned long lastQuery = 0;
+unsigned long lastReport = 0;
+unsigned long reportStart = 0;
+
+void setup()
+{
+  Serial.begin( 9600 );
+  
+  // The DFRobot device is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  // Setup the built-in LED
+  pinMode( LED_BUILTIN, OUTPUT );
+
+  reportStart = micros();
+}
+
+void loop()
+{
+  // Sleep until it's time for the next query; every wake-up (at least once
+  // per millisecond, from the timer behind millis()) checks again
+  while( millis() - lastQuery < queryInterval )
+    MeasuredSleepIdle::wait();
+
+  lastQuery = millis();
+
+  bool presence = false;
+  if( sensor.readPresence( presence ) )
+    digitalWrite( LED_BUILTIN, presence );
+
+  if( millis() - lastReport < reportInterval )
+    return;
+
+  lastReport = millis();
+
+  const unsigned long elapsed = micros() - reportStart;
+  const float dutyCycle = 1.0 - float( asleep ) / elapsed;
+  const float averageCurrent = dutyCycle * activeCurrent + ( 1.0 - dutyCycle ) * sleepCurrent;
+
+  Serial.print( "Awake: " );
+  Serial.print( dutyCycle * 100, 1 );
+  Serial.print( " %  average current: " );
+  Serial.print( averageCurrent, 2 );
+  Serial.println( " mA" );
+
+  // Don't count the time spent printing in the next report
+  Serial.flush();
+  asleep = 0;
+  reportStart = micros();
+}
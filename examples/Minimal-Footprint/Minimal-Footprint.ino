@@ -0,0 +1,57 @@
+/**
+ * DFR_Radar: Minimal-Footprint.ino
+ * 
+ * This is the Basic.ino example, built with a trimmed-down policy for
+ * boards that are short on RAM and flash.  The sensor is assumed to be
+ * configured already (e.g. with Basic.ino), so this sketch only queries it
+ * for presence, and everything it doesn't need is compiled out: the command
+ * queue, the configuration cache and health tracking, write-back mode, the
+ * tap, the latency timestamps and the debug output.  Calls to the serial
+ * port are also bound to Serial1's own class at compile time, rather than
+ * going through `Stream`.
+ *
+ * Compare the flash and RAM usage reported for this sketch with Basic.ino
+ * to see what the default policy costs.
+ * 
+ * When motion is detected, it will turn on the built-in LED.
+ */
+
+#include <DFR_Radar.h>
+
+// Start from the defaults, then take out what this sketch doesn't use
+struct PresenceOnlyTraits : DFR_RadarTraits
+{
+  static constexpr size_t packetLength = 48;
+  static constexpr uint8_t pipelineDepth = 0;
+  static constexpr uint8_t configCacheSlots = 0;
+  static constexpr bool healthMonitor = false;
+  static constexpr bool writeBack = false;
+  static constexpr bool tap = false;
+  static constexpr bool floatSupport = false;
+  static constexpr bool timestamps = false;
+  typedef DFR_RadarNoLog Log;
+
+  // Talk to Serial1 directly instead of through `Stream`'s virtual methods
+  typedef DFR_RadarPortTransport<decltype( Serial1 )> Transport;
+};
+
+// Serial1 is the hardware UART pins
+DFR_RadarT<PresenceOnlyTraits> sensor( &Serial1 );
+
+void setup()
+{
+  // The DFRobot device is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  // Setup the built-in LED
+  pinMode( LED_BUILTIN, OUTPUT );
+}
+
+void loop()
+{
+  // Query the presence detection status
+  bool presence = sensor.checkPresence();
+
+  // If presence == true, turn on the built-in LED.
+  digitalWrite( LED_BUILTIN, presence );
+}
@@ -0,0 +1,86 @@
+/**
+ * DFR_Radar: Occupancy-Heatmap.ino
+ *
+ * This example shows where in the detection range people spend their
+ * time, rather than only whether anyone is there.  It reads the sensor's
+ * point cloud ($JYRPO) five times a second and accumulates it into a
+ * DFR_RadarHeatmap: 12 range bins of half a metre, by 4 velocity bins,
+ * in 96 bytes of RAM.  Old hits fade out, to half in about 45 seconds.
+ *
+ * Every 10 seconds it prints a snapshot of the heatmap, one row per range
+ * bin (nearest first), scaled so the busiest cell is 255.  That's what
+ * would be uploaded instead of the raw frames.
+ */
+
+#include <DFR_Radar.h>
+#include <DFR_RadarHeatmap.h>
+
+// Serial1 is the hardware UART pins
+DFR_Radar sensor( &Serial1 );
+
+// 0-6 m, from 1 m/s approaching to 1 m/s receding; hits fade to half in about 0.7 x 2^6 frames
+DFR_RadarHeatmap<12, 4> heatmap( 6000, 1000, 6 );
+
+DFR_RadarPoint points[16];
+
+const unsigned long frameInterval = 200;
+const unsigned long reportInterval = 10000;
+unsigned long lastFrame = 0;
+unsigned long lastReport = 0;
+
+void report()
+{
+  uint8_t image[heatmap.cells];
+  heatmap.snapshot( image, sizeof( image ) );
+
+  Serial.print( "Heatmap after " );
+  Serial.print( heatmap.getFrameCount() );
+  Serial.print( " frames, " );
+  Serial.print( heatmap.getHitCount() );
+  Serial.println( " points:" );
+
+  for( uint8_t range = 0; range < 12; range++ )
+  {
+    Serial.print( heatmap.getBinRange( range ) );
+    Serial.print( " mm\t" );
+
+    for( uint8_t velocity = 0; velocity < 4; velocity++ )
+    {
+      Serial.print( image[range * 4 + velocity] );
+      Serial.print( '\t' );
+    }
+
+    Serial.println();
+  }
+}
+
+void setup()
+{
+  Serial.begin( 9600 );
+
+  // The DFRobot device is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  // Only send the point cloud when asked for it (passive mode)
+  sensor.configBegin();
+  sensor.configureUartPointCloudOutput( true, false, 1501 );
+  sensor.configEnd();
+}
+
+void loop()
+{
+  if( millis() - lastFrame >= frameInterval )
+  {
+    lastFrame = millis();
+
+    uint8_t count;
+    if( sensor.readPointCloud( points, 16, count ) )
+      heatmap.update( points, count );
+  }
+
+  if( millis() - lastReport >= reportInterval )
+  {
+    lastReport = millis();
+    report();
+  }
+}
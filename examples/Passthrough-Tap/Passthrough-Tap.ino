@@ -0,0 +1,53 @@
+/**
+ * DFR_Radar: Passthrough-Tap.ino
+ *
+ * This example does what DirectSerial does -- connect the USB serial
+ * console to the sensor's UART -- but without taking the sensor out of
+ * service: the library keeps reading presence (and driving the built-in
+ * LED) while a vendor tool or a terminal talks to the sensor.
+ *
+ * Everything the sensor sends is mirrored to USB serial, including the
+ * library's own traffic.  To see only the $JYBSS and $JYRPO frames, start
+ * the console with `DFR_Radar::TapFrames` instead.  Commands typed on USB
+ * serial are sent to the sensor a whole line at a time, between the
+ * library's own commands.
+ */
+
+#include <DFR_Radar.h>
+#include <DFR_RadarPassthrough.h>
+
+// Serial1 is the hardware UART pins
+DFR_Radar sensor( &Serial1 );
+
+DFR_RadarPassthrough<DFR_Radar> console( sensor, Serial );
+
+const unsigned long presenceInterval = 1000;
+unsigned long lastPresence = 0;
+
+void setup()
+{
+  // The USB serial console must be fast enough to keep up with the sensor
+  Serial.begin( 115200 );
+
+  // The radar sensor is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  console.begin( DFR_Radar::TapEverything );
+
+  // Setup the built-in LED
+  pinMode( LED_BUILTIN, OUTPUT );
+}
+
+void loop()
+{
+  if( millis() - lastPresence >= presenceInterval )
+  {
+    lastPresence = millis();
+
+    bool presence;
+    if( sensor.readPresence( presence ) )
+      digitalWrite( LED_BUILTIN, presence );
+  }
+
+  console.run();
+}
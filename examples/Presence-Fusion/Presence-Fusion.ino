@@ -0,0 +1,82 @@
+/**
+ * DFR_Radar: Presence-Fusion.ino
+ * 
+ * This example watches one room with two sensors whose detection areas
+ * overlap, and combines their readings with a DFR_RadarFusion into a
+ * single decision, instead of trusting whichever one was asked last.
+ *
+ * With the Majority policy and two sensors, the room only becomes occupied
+ * once both agree, and only becomes empty once both agree; while they
+ * disagree, the previous decision stands.  A sensor that stops answering
+ * drops out of the vote after two seconds, leaving the other in charge.
+ *
+ * Try the other policies: Any (either sensor is enough), Weighted (see
+ * `setWeight()`), or ZoneOverlap for rooms where only some of the sensors
+ * overlap (see `setZones()`, and `updateFrame()` to place each detection in
+ * a zone by its range).
+ * 
+ * When the room is occupied, it will turn on the built-in LED.
+ */
+
+#include <DFR_Radar.h>
+#include <DFR_RadarFusion.h>
+#include <SoftwareSerial.h>
+
+const byte rxPin = 2;
+const byte txPin = 3;
+
+#ifdef ESP32
+  EspSoftwareSerial::UART secondSerial;
+#else
+  SoftwareSerial secondSerial( rxPin, txPin );
+#endif
+
+// One sensor on the hardware UART, the other on software serial
+DFR_Radar first( &Serial1 );
+DFR_Radar second( &secondSerial );
+
+// Two sensors; a reading counts for 2 seconds
+DFR_RadarFusion<2> room( DFR_RadarFusion<2>::Majority, 2000 );
+
+bool lastOccupied = false;
+
+void setup()
+{
+  Serial.begin( 9600 );
+  
+  // The DFRobot device is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  #ifdef ESP32
+    secondSerial.begin( 115200, SWSERIAL_8N1, rxPin, txPin );
+  #else
+    secondSerial.begin( 115200 );
+  #endif
+
+  // Setup the built-in LED
+  pinMode( LED_BUILTIN, OUTPUT );
+}
+
+void loop()
+{
+  // Ask each sensor in turn; one that doesn't answer just doesn't get a say
+  room.poll( 0, first );
+  room.poll( 1, second );
+
+  bool occupied = room.isOccupied();
+
+  // If occupied == true, turn on the built-in LED.
+  digitalWrite( LED_BUILTIN, occupied );
+
+  if( occupied == lastOccupied )
+    return;
+
+  lastOccupied = occupied;
+
+  Serial.print( "Occupied: " );
+  Serial.print( occupied );
+  Serial.print( "  sensors reporting: " );
+  Serial.print( room.getFreshCount() );
+  Serial.print( "  detecting: " );
+  Serial.println( room.getPresentCount() );
+}
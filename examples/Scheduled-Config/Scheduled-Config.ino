@@ -0,0 +1,90 @@
+/**
+ * DFR_Radar: Scheduled-Config.ino
+ * 
+ * This example changes the sensor's configuration while it's in use,
+ * without going blind in the meantime.  Instead of calling the setters
+ * one after the other (which keeps the sensor stopped, and `loop()`
+ * waiting, until they're all done), the commands are queued with a
+ * DFR_RadarScheduler, which sends them one at a time and reads presence
+ * in between whenever it's due.
+ *
+ * Every 30 seconds, it toggles between two detection ranges.  When each
+ * batch is done, it prints how long the commands waited and how stale the
+ * presence reading got at worst.
+ * 
+ * When motion is detected, it will turn on the built-in LED.
+ */
+
+#include <DFR_Radar.h>
+#include <DFR_RadarScheduler.h>
+
+// Serial1 is the hardware UART pins
+DFR_Radar sensor( &Serial1 );
+
+// Read presence every 200ms, even while reconfiguring
+DFR_RadarScheduler<DFR_Radar> scheduler( sensor, 200 );
+
+const unsigned long reconfigureInterval = 30000;
+unsigned long lastReconfigure = 0;
+bool nearby = false;
+
+void reconfigure()
+{
+  nearby = !nearby;
+
+  const float range[] = { 0, nearby ? 1.5f : 6.0f };
+  const float sensitivity[] = { nearby ? 3.0f : 7.0f };
+  const float latency[] = { 0.025, nearby ? 2.0f : 10.0f };
+
+  scheduler.schedule( DFR_RadarCommands::setRange, range );
+  scheduler.schedule( DFR_RadarCommands::setSensitivity, sensitivity );
+  scheduler.schedule( DFR_RadarCommands::setLatency, latency );
+
+  Serial.println( nearby ? "Switching to nearby detection" : "Switching to whole-room detection" );
+}
+
+void setup()
+{
+  Serial.begin( 9600 );
+  
+  // The DFRobot device is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  // Save each batch to flash once, after its last command
+  sensor.setWriteBack( true );
+
+  // Setup the built-in LED
+  pinMode( LED_BUILTIN, OUTPUT );
+}
+
+void loop()
+{
+  if( millis() - lastReconfigure >= reconfigureInterval )
+  {
+    lastReconfigure = millis();
+    reconfigure();
+  }
+
+  const bool busy = scheduler.isBusy();
+
+  scheduler.run();
+
+  // If presence == true, turn on the built-in LED.
+  digitalWrite( LED_BUILTIN, scheduler.getPresence() );
+
+  // Report once a batch has been sent and saved
+  if( !busy || scheduler.isBusy() )
+    return;
+
+  Serial.print( "Done: " );
+  Serial.print( scheduler.getCompletedCount() );
+  Serial.print( " sent, " );
+  Serial.print( scheduler.getFailedCount() );
+  Serial.print( " failed, average wait " );
+  Serial.print( scheduler.getAverageWait() );
+  Serial.print( " ms, longest wait " );
+  Serial.print( scheduler.getMaxWait() );
+  Serial.print( " ms, stalest presence " );
+  Serial.print( scheduler.getMaxPresenceAge() );
+  Serial.println( " ms" );
+}
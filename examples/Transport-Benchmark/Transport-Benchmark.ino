@@ -0,0 +1,73 @@
+/**
+ * DFR_Radar: Transport-Benchmark.ino
+ * 
+ * This example measures how many CPU cycles DFR_Radar spends on each byte
+ * it receives from the sensor, first with the default transport (which
+ * goes through `Stream`'s virtual methods, a byte at a time), then with a
+ * transport bound to the port's own class at compile time, which also uses
+ * the port's bulk read.
+ *
+ * No sensor is needed: both drivers talk to a DFR_RadarMemoryPort, which
+ * answers every query with a recorded presence reply, so only the library's
+ * own overhead is measured (sending the query, reading the reply and
+ * parsing it).  To see the difference on your board, compare the two
+ * results in the Serial Monitor.
+ */
+
+#include <DFR_Radar.h>
+
+// What the sensor sends back for a presence query, with command echo on
+const char reply[] = "getOutput 1\r\nDone\r\nleapMMW:/>$JYBSS,1, , , *\r\n";
+
+DFR_RadarMemoryPort port( reply );
+
+// The default transport, as used with `DFR_Radar sensor( &Serial1 )`
+DFR_Radar viaStream( &port );
+
+// The same driver, with calls to the port bound at compile time
+struct InlinedTraits : DFR_RadarTraits
+{
+  typedef DFR_RadarPortTransport<DFR_RadarMemoryPort> Transport;
+};
+
+DFR_RadarT<InlinedTraits> viaPort( &port );
+
+const uint16_t iterations = 500;
+
+template<typename Radar>
+void benchmark( const char *name, Radar &sensor )
+{
+  bool presence = false;
+
+  const unsigned long start = micros();
+
+  for( uint16_t i = 0; i < iterations; i++ )
+    sensor.readPresence( presence );
+
+  const unsigned long elapsed = micros() - start;
+
+  const float bytes = float( iterations ) * port.getReplyLength();
+  const float cyclesPerByte = elapsed * ( F_CPU / 1000000.0 ) / bytes;
+
+  Serial.print( name );
+  Serial.print( ": " );
+  Serial.print( cyclesPerByte, 1 );
+  Serial.println( " cycles/byte" );
+}
+
+void setup()
+{
+  Serial.begin( 9600 );
+
+  while( !Serial )
+    ;
+}
+
+void loop()
+{
+  benchmark( "Stream transport", viaStream );
+  benchmark( "Port transport  ", viaPort );
+  Serial.println();
+
+  delay( 5000 );
+}
@@ -0,0 +1,77 @@
+/**
+ * DFR_Radar: Warm-Start.ino
+ * 
+ * This example configures the sensor from a profile, the way the Basic
+ * example does with a factory reset and a series of setters, but only when
+ * it has to.  A fingerprint of the profile is kept in memory that survives
+ * a reset of the MCU (watchdog, reset button, OTA update), so when the
+ * sketch restarts while the sensor stays powered, `begin()` only reads the
+ * settings back to confirm them, which takes milliseconds instead of
+ * seconds and doesn't wear the sensor's flash.
+ *
+ * Press the reset button to see the difference; change the profile and
+ * upload again to see it reconfigure.
+ *
+ * On an ESP32, the fingerprint is kept in RTC memory, which also survives
+ * deep sleep.  On AVR, it's in a section the C runtime doesn't clear at
+ * startup.  To also survive power loss, keep it in EEPROM or NVS instead.
+ * 
+ * When motion is detected, it will turn on the built-in LED.
+ */
+
+#include <DFR_Radar.h>
+
+#if defined( ESP32 )
+  RTC_NOINIT_ATTR uint32_t fingerprint;
+#elif defined( __AVR__ )
+  uint32_t fingerprint __attribute__(( section( ".noinit" ) ));
+#else
+  // Nowhere that survives a reset, so every start will be a cold one
+  uint32_t fingerprint = 0;
+#endif
+
+// Serial1 is the hardware UART pins
+DFR_Radar sensor( &Serial1 );
+
+// Everything the sketch wants set; the rest stays at the factory settings
+const DFR_RadarCommandValues profile[] = {
+  { &DFR_RadarCommands::setRange,       { 0, 3 } },    // 0 to 3 meters
+  { &DFR_RadarCommands::setSensitivity, { 7 } },
+  { &DFR_RadarCommands::setLatency,     { 0.025, 5 } } // on after 25ms, off after 5s
+};
+
+const uint8_t profileLength = sizeof( profile ) / sizeof( profile[0] );
+
+void setup()
+{
+  Serial.begin( 9600 );
+  
+  // The DFRobot device is factory-set for 115200 baud
+  Serial1.begin( 115200 );
+
+  // Setup the built-in LED
+  pinMode( LED_BUILTIN, OUTPUT );
+
+  const unsigned long start = millis();
+  const bool configured = sensor.begin( profile, profileLength, fingerprint );
+  const unsigned long elapsed = millis() - start;
+
+  if( !configured )
+    Serial.print( "Configuring the sensor failed" );
+  else if( sensor.isWarmStart() )
+    Serial.print( "Warm start: configuration confirmed" );
+  else
+    Serial.print( "Cold start: sensor configured" );
+
+  Serial.print( " in " );
+  Serial.print( elapsed );
+  Serial.println( " ms" );
+}
+
+void loop()
+{
+  bool presence = sensor.checkPresence();
+
+  // If presence == true, turn on the built-in LED.
+  digitalWrite( LED_BUILTIN, presence );
+}
@@ -0,0 +1,87 @@
+/**
+  * @file       Arduino.h
+  * @brief      The parts of the Arduino core that DFR_Radar uses, for building it natively on Linux
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * @note Only for host builds (put this directory on the include path ahead of anything else);
+  *       the Arduino IDE and PlatformIO never look in `extras/`.
+  */
+
+
+#ifndef DFR_Radar_LinuxArduino_H_
+#define DFR_Radar_LinuxArduino_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+using std::min;
+using std::max;
+
+inline unsigned long millis() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<unsigned long>(now.tv_sec) * 1000UL + now.tv_nsec / 1000000UL;
+}
+
+inline unsigned long micros() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<unsigned long>(now.tv_sec) * 1000000UL + now.tv_nsec / 1000UL;
+}
+
+inline void delay(const unsigned long ms) { usleep(ms * 1000); }
+inline void yield() {}
+
+inline bool isWhitespace(const int c) { return c == ' ' || c == '\t'; }
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+        size_t written = 0;
+        while (size--)
+            written += write(*buffer++);
+        return written;
+    }
+
+    size_t write(const char *text) { return write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+    size_t print(const char *text) { return write(text); }
+
+    virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+/**
+ * @brief `Serial` is standard output, so debug output from `setDebug(true)` lands in the terminal
+ */
+class DFR_RadarStdout : public Print {
+public:
+    size_t write(const uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    size_t write(const uint8_t *buffer, const size_t size) override { return fwrite(buffer, 1, size, stdout); }
+    void flush() override { fflush(stdout); }
+    using Print::write;
+};
+
+static DFR_RadarStdout Serial;
+
+#endif
@@ -0,0 +1,141 @@
+/**
+  * @file       cloud-codec.cpp
+  * @brief      Encodes captured point cloud output with DFR_RadarCloudEncoder, or decodes the result
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * `encode` reads the sensor's output as text (e.g. captured from its UART), picks out the
+  * $JYRPO frames and writes each one encoded, with its length in front (u16, little-endian).
+  * How much smaller the frames got, and how long encoding took, goes to standard error.
+  * `decode` reads that back and prints every frame's points, one frame per line.
+  *
+  *     cloud-codec encode [-r range-step] [-v velocity-step] [-m magnitude-step] [-k keyframe-interval] < capture.txt > frames.bin
+  *     cloud-codec decode < frames.bin
+  */
+
+#include <Arduino.h>
+#include <DFR_RadarCloudCodec.h>
+#include <DFR_RadarPointCloud.h>
+#include <time.h>
+
+
+static constexpr uint8_t maxPoints = 32;
+
+static double seconds() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static int usage(const char *name) {
+    fprintf(stderr, "usage: %s encode [-r range-step] [-v velocity-step] [-m magnitude-step] [-k keyframe-interval]\n"
+                    "       %s decode\n", name, name);
+    return 1;
+}
+
+static int encode(const uint8_t rangeStep, const uint8_t velocityStep, const uint8_t magnitudeStep, const uint8_t keyframeInterval) {
+    DFR_RadarPoint points[maxPoints];
+    DFR_RadarPointCloud cloud(points, maxPoints);
+    DFR_RadarCloudEncoder<maxPoints> encoder(rangeStep, velocityStep, magnitudeStep, keyframeInterval);
+
+    uint8_t frame[2 + DFR_RadarCloudFormat::maxFrameLength(maxPoints)];
+    char line[256];
+    unsigned long textBytes = 0;
+    double elapsed = 0;
+
+    while (fgets(line, sizeof(line), stdin) != nullptr) {
+        const size_t length = strlen(line);
+
+        // What the sensor sent for the frames; it ends lines with CR LF, which a capture may have made LF
+        if (strstr(line, "$JYRPO") != nullptr) {
+            textBytes += length;
+            if (line[length - 1] == '\n' && (length < 2 || line[length - 2] != '\r'))
+                textBytes++;
+        }
+
+        if (!cloud.decode(line, length))
+            continue;
+
+        const double start = seconds();
+        const size_t encoded = encoder.encode(cloud.getPoints(), cloud.getCount(), frame + 2, sizeof(frame) - 2);
+        elapsed += seconds() - start;
+
+        frame[0] = encoded & 0xFF;
+        frame[1] = encoded >> 8;
+        fwrite(frame, 1, encoded + 2, stdout);
+    }
+
+    const uint32_t frames = encoder.getFrameCount();
+    const uint32_t bytes = encoder.getByteCount();
+
+    fprintf(stderr, "%u frames (%u keyframes), %lu bytes of text -> %u bytes", frames, encoder.getKeyframeCount(), textBytes, bytes);
+    if (frames && bytes)
+        fprintf(stderr, ", %.1fx smaller, %.2f bytes/frame, %.0f ns/frame",
+                static_cast<double>(textBytes) / bytes, static_cast<double>(bytes) / frames, elapsed * 1e9 / frames);
+    fprintf(stderr, "; %u incomplete, %u malformed\n", cloud.getIncompleteCount(), cloud.getMalformedCount());
+
+    return ferror(stdin) || ferror(stdout) ? 1 : 0;
+}
+
+static int decode() {
+    DFR_RadarCloudDecoder<maxPoints> decoder;
+    DFR_RadarPoint points[maxPoints];
+    uint8_t frame[DFR_RadarCloudFormat::maxFrameLength(maxPoints)];
+    uint8_t prefix[2];
+    unsigned long frames = 0;
+
+    while (fread(prefix, 1, 2, stdin) == 2) {
+        const size_t length = prefix[0] | prefix[1] << 8;
+        if (length > sizeof(frame) || fread(frame, 1, length, stdin) != length) {
+            fprintf(stderr, "frame %lu is cut short or too long\n", frames);
+            break;
+        }
+
+        frames++;
+
+        uint8_t count;
+        if (!decoder.decode(frame, length, points, maxPoints, count))
+            continue;
+
+        printf("%2u:", count);
+        for (uint8_t i = 0; i < count; i++)
+            printf("  %u.%03u m %+d mm/s %u.%u dB", points[i].range / 1000, points[i].range % 1000, points[i].velocity,
+                   points[i].magnitude / 10, points[i].magnitude % 10);
+        printf("\n");
+    }
+
+    fprintf(stderr, "%lu frames read, %u decoded, %u skipped, %u missing, %u malformed\n", frames, decoder.getFrameCount(),
+            decoder.getSkippedCount(), decoder.getMissingCount(), decoder.getMalformedCount());
+
+    return ferror(stdin) || decoder.getMalformedCount() ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2)
+        return usage(argv[0]);
+
+    if (strcmp(argv[1], "decode") == 0)
+        return argc == 2 ? decode() : usage(argv[0]);
+
+    if (strcmp(argv[1], "encode") != 0)
+        return usage(argv[0]);
+
+    // Steps in mm, mm/s and 0.1 dB, and one keyframe in 16 frames
+    unsigned long steps[4] = { 10, 10, 5, 16 };
+    const char *const options[4] = { "-r", "-v", "-m", "-k" };
+
+    for (int i = 2; i < argc; i += 2) {
+        int option = 0;
+        while (option < 4 && strcmp(argv[i], options[option]) != 0)
+            option++;
+
+        if (option == 4 || i + 1 == argc)
+            return usage(argv[0]);
+
+        steps[option] = strtoul(argv[i + 1], nullptr, 0);
+        if (steps[option] < 1 || steps[option] > 255)
+            return usage(argv[0]);
+    }
+
+    return encode(steps[0], steps[1], steps[2], steps[3]);
+}
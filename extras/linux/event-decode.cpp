@@ -0,0 +1,200 @@
+/**
+  * @file       event-decode.cpp
+  * @brief      Prints the events in a log written by DFR_RadarEventLog, one per line
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * Reads the blocks from each file given (or standard input), checks them, and prints every
+  * record with its absolute time in milliseconds.  A summary of what was read goes to
+  * standard error, including any blocks missing from the sequence or unreadable.
+  *
+  *     event-decode [-b block-size] [file ...]
+  */
+
+#include <Arduino.h>
+#include <DFR_RadarEventLog.h>
+
+
+struct DecodeTotals {
+    unsigned long blocks;
+    unsigned long records;
+    unsigned long damaged;
+    unsigned long missing;
+    unsigned long bytes;
+    bool started;
+    uint32_t nextSequence;
+};
+
+static const char *healthName(const uint8_t state) {
+    // DFR_RadarT::HealthState
+    static const char *const names[] = { "healthy", "degraded", "unhealthy", "recovering" };
+    return state < sizeof(names) / sizeof(names[0]) ? names[state] : "unknown";
+}
+
+static uint32_t readLittleEndian(const uint8_t *buffer) {
+    return buffer[0] | buffer[1] << 8 | static_cast<uint32_t>(buffer[2]) << 16 | static_cast<uint32_t>(buffer[3]) << 24;
+}
+
+/**
+ * @return the number of bytes the varint took, or 0 if it runs past `end` or is too long
+ */
+static size_t readVarint(const uint8_t *buffer, const uint8_t *end, uint32_t &value) {
+    value = 0;
+
+    for (size_t i = 0; i < 5 && buffer + i < end; i++) {
+        value |= static_cast<uint32_t>(buffer[i] & 0x7F) << (7 * i);
+        if (!(buffer[i] & 0x80))
+            return i + 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @return false if the block is damaged; the records before the damage have been printed
+ */
+static bool decodeBlock(const uint8_t *block, const size_t size, DecodeTotals &totals) {
+    if (size < DFR_RadarEventFormat::headerLength)
+        return false;
+
+    const uint16_t magic = block[0] | block[1] << 8;
+    if (magic != DFR_RadarEventFormat::magic || block[2] != DFR_RadarEventFormat::version)
+        return false;
+
+    const uint32_t sequence = readLittleEndian(block + 4);
+    uint32_t time = readLittleEndian(block + 8);
+
+    if (totals.started && sequence != totals.nextSequence) {
+        fprintf(stderr, "blocks %u to %u are missing\n", totals.nextSequence, sequence - 1);
+        totals.missing += sequence - totals.nextSequence;
+    }
+
+    totals.started = true;
+    totals.nextSequence = sequence + 1;
+
+    const uint8_t *position = block + DFR_RadarEventFormat::headerLength;
+    const uint8_t *end = block + size;
+
+    while (position < end && *position != DFR_RadarEventFormat::End) {
+        const uint8_t type = *position & 0x0F;
+        const uint8_t sensor = *position >> 4;
+        position++;
+
+        uint32_t delta;
+        const size_t length = readVarint(position, end, delta);
+        if (!length)
+            return false;
+
+        position += length;
+        time += delta;
+
+        switch (type) {
+            case DFR_RadarEventFormat::PresenceCleared:
+            case DFR_RadarEventFormat::PresenceDetected:
+                printf("%10u  %2u  presence   %s\n", time, sensor, type == DFR_RadarEventFormat::PresenceDetected ? "detected" : "cleared");
+                break;
+
+            case DFR_RadarEventFormat::Health:
+                if (end - position < 1)
+                    return false;
+
+                printf("%10u  %2u  health     %s -> %s\n", time, sensor, healthName(*position >> 4), healthName(*position & 0x0F));
+                position++;
+                break;
+
+            case DFR_RadarEventFormat::Occupancy:
+                if (end - position < 3)
+                    return false;
+
+                printf("%10u  %2u  occupancy  zones 0x%02x  reporting %u  detecting %u\n", time, sensor, position[0], position[1], position[2]);
+                position += 3;
+                break;
+
+            case DFR_RadarEventFormat::PointCloud: {
+                if (end - position < 5)
+                    return false;
+
+                const unsigned nearest = position[1] | position[2] << 8;
+                const unsigned peak = position[3] | position[4] << 8;
+
+                printf("%10u  %2u  points     %u  nearest %u.%03u m  peak %u.%u dB\n", time, sensor, position[0],
+                       nearest / 1000, nearest % 1000, peak / 10, peak % 10);
+                position += 5;
+                break;
+            }
+
+            default:
+                return false;
+        }
+
+        totals.records++;
+    }
+
+    return true;
+}
+
+static bool decodeFile(FILE *file, const char *name, const size_t blockSize, DecodeTotals &totals) {
+    uint8_t *block = static_cast<uint8_t *>(malloc(blockSize));
+    if (block == nullptr)
+        return false;
+
+    size_t got;
+    while ((got = fread(block, 1, blockSize, file)) > 0) {
+        totals.bytes += got;
+
+        if (got < blockSize)
+            fprintf(stderr, "%s: the last block is only %zu bytes\n", name, got);
+
+        if (!decodeBlock(block, got, totals)) {
+            fprintf(stderr, "%s: block %lu is damaged\n", name, totals.blocks);
+            totals.damaged++;
+        }
+
+        totals.blocks++;
+    }
+
+    const bool success = !ferror(file);
+    free(block);
+    return success;
+}
+
+int main(int argc, char **argv) {
+    size_t blockSize = 512;
+    int first = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-b") == 0) {
+        blockSize = strtoul(argv[2], nullptr, 0);
+        first = 3;
+    }
+
+    if (blockSize < DFR_RadarEventFormat::headerLength + DFR_RadarEventFormat::longestRecord) {
+        fprintf(stderr, "usage: %s [-b block-size] [file ...]\n", argv[0]);
+        return 1;
+    }
+
+    DecodeTotals totals;
+    memset(&totals, 0, sizeof(totals));
+    bool success = true;
+
+    if (first == argc)
+        success = decodeFile(stdin, "stdin", blockSize, totals);
+
+    for (int i = first; i < argc; i++) {
+        FILE *file = fopen(argv[i], "rb");
+        if (file == nullptr) {
+            perror(argv[i]);
+            success = false;
+            continue;
+        }
+
+        success = decodeFile(file, argv[i], blockSize, totals) && success;
+        fclose(file);
+    }
+
+    fprintf(stderr, "%lu blocks, %lu records", totals.blocks, totals.records);
+    if (totals.records)
+        fprintf(stderr, ", %.2f bytes/record", static_cast<double>(totals.bytes) / totals.records);
+    fprintf(stderr, ", %lu damaged, %lu missing\n", totals.damaged, totals.missing);
+
+    return success && !totals.damaged ? 0 : 1;
+}
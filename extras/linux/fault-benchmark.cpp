@@ -0,0 +1,177 @@
+/**
+  * @file       fault-benchmark.cpp
+  * @brief      Measures how the driver's latency and success rate degrade on a faulty UART
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * Runs sendCommand() (through reboot()), getConfig() (through getDetectionRange()) and
+  * readPresence() against in-memory sensors behind a DFR_RadarFaultyStream, once per fault
+  * scenario, and prints for each:
+  *
+  *   - how many calls succeeded, and how many of those returned the wrong value
+  *   - the latency of the successful ones (median, 90th and 99th percentile, worst)
+  *   - the latency of the failed ones (median), i.e. what a failure costs
+  *
+  * Use it to pick timeouts and retry counts: the percentiles show how long a call needs on a
+  * given line, and the failure latency shows what a retry costs.  The health monitor is off,
+  * so every call goes to the "sensor".  Each scenario stops after `trials` calls or 10 s.
+  *
+  *     fault-benchmark [trials] [filter]
+  */
+
+#include <Arduino.h>
+#include <DFR_Radar.h>
+#include <DFR_RadarFaultyStream.h>
+
+#include <algorithm>
+#include <vector>
+
+
+struct FaultTraits : DFR_RadarTraits {
+    static constexpr bool healthMonitor = false;
+    typedef DFR_RadarNoLog Log;
+    typedef DFR_RadarBusyIdle Idle;
+};
+
+typedef DFR_RadarT<FaultTraits> FaultyRadar;
+typedef DFR_RadarFaultyStream<> FaultyStream;
+
+static constexpr unsigned long budget = 10000;
+
+/**
+ * @brief A kind of field fault, and how it's set up
+ */
+struct FaultScenario {
+    const char *name;
+    void (*setUp)(FaultyStream &faulty);
+};
+
+/**
+ * @brief A call to measure: what the sensor answers, and whether the call got the right result
+ */
+struct FaultOperation {
+    const char *name;
+    const char *reply;
+
+    /**
+     * @return false if the call failed; `correct` is set to whether the value it returned is right
+     */
+    bool (*call)(FaultyRadar &radar, bool &correct);
+};
+
+static bool sendCommand(FaultyRadar &radar, bool &correct) {
+    correct = true;
+    return radar.reboot();
+}
+
+static bool getConfig(FaultyRadar &radar, bool &correct) {
+    float minimum = 0, maximum = 0;
+    const bool success = radar.getDetectionRange(minimum, maximum);
+
+    correct = minimum == 0.5f && maximum == 6.25f;
+    return success;
+}
+
+static bool readPresence(FaultyRadar &radar, bool &correct) {
+    bool presence = false;
+    const bool success = radar.readPresence(presence);
+
+    correct = presence;
+    return success;
+}
+
+static const FaultOperation operations[] = {
+    { "sendCommand",  "resetSystem 0\r\nDone\r\nleapMMW:/>",                      sendCommand },
+    { "getConfig",    "getRange\r\nResponse 0.500 6.250\r\nDone\r\nleapMMW:/>",   getConfig },
+    { "readPresence", "getOutput 1\r\nDone\r\nleapMMW:/>$JYBSS,1, , , *\r\n",     readPresence }
+};
+
+static const FaultScenario scenarios[] = {
+    { "clean",          [](FaultyStream &) {} },
+    { "delay 20+-10ms", [](FaultyStream &faulty) { faulty.setDelay(10, 20); } },
+    { "delay 80+-40ms", [](FaultyStream &faulty) { faulty.setDelay(40, 80); } },
+    { "5% late 1.2s",   [](FaultyStream &faulty) { faulty.setLateResponses(0.05, 1200); } },
+    { "byte loss 0.1%", [](FaultyStream &faulty) { faulty.setByteLoss(0.001); } },
+    { "byte loss 1%",   [](FaultyStream &faulty) { faulty.setByteLoss(0.01); } },
+    { "corruption 1%",  [](FaultyStream &faulty) { faulty.setCorruption(0.01); } },
+    { "noise 1%x8",     [](FaultyStream &faulty) { faulty.setNoise(0.01, 8); } },
+    { "CR only",        [](FaultyStream &faulty) { faulty.setLineEnding(FaultyStream::CarriageReturn); } },
+    { "LF only",        [](FaultyStream &faulty) { faulty.setLineEnding(FaultyStream::LineFeed); } },
+    { "repeats 10%",    [](FaultyStream &faulty) { faulty.setRepeatedLines(0.1); } },
+    { "frames 25%",     [](FaultyStream &faulty) { faulty.setInjectedFrames(0.25); } },
+    { "field mix",      [](FaultyStream &faulty) {
+                            faulty.setDelay(10, 20);
+                            faulty.setLateResponses(0.01, 1200);
+                            faulty.setByteLoss(0.001);
+                            faulty.setCorruption(0.001);
+                            faulty.setRepeatedLines(0.02);
+                            faulty.setInjectedFrames(0.1);
+                        } }
+};
+
+static double milliseconds(const std::vector<unsigned long> &sorted, const double fraction) {
+    if (sorted.empty())
+        return 0;
+
+    return sorted[static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5)] / 1000.0;
+}
+
+static void run(const FaultScenario &scenario, const FaultOperation &operation, const unsigned trials) {
+    DFR_RadarMemoryPort sensor(operation.reply);
+    FaultyStream faulty(sensor);
+    scenario.setUp(faulty);
+
+    FaultyRadar radar(&faulty);
+    std::vector<unsigned long> successes, failures;
+    unsigned wrong = 0;
+
+    const unsigned long start = millis();
+
+    for (unsigned i = 0; i < trials && millis() - start < budget; i++) {
+        bool correct = false;
+        const unsigned long callStart = micros();
+        const bool success = operation.call(radar, correct);
+        const unsigned long latency = micros() - callStart;
+
+        if (success) {
+            successes.push_back(latency);
+            wrong += !correct;
+        } else {
+            failures.push_back(latency);
+        }
+    }
+
+    std::sort(successes.begin(), successes.end());
+    std::sort(failures.begin(), failures.end());
+
+    const size_t calls = successes.size() + failures.size();
+
+    printf("%-15s %-13s %5zu %6.1f%% %6u %9.2f %9.2f %9.2f %9.2f %9.2f\n", scenario.name, operation.name, calls,
+           100.0 * successes.size() / calls, wrong,
+           milliseconds(successes, 0.5), milliseconds(successes, 0.9), milliseconds(successes, 0.99),
+           milliseconds(successes, 1), milliseconds(failures, 0.5));
+}
+
+int main(int argc, char **argv) {
+    const unsigned trials = argc > 1 ? strtoul(argv[1], nullptr, 0) : 100;
+    const char *filter = argc > 2 ? argv[2] : "";
+
+    if (!trials) {
+        fprintf(stderr, "usage: %s [trials] [filter]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-15s %-13s %5s %7s %6s %9s %9s %9s %9s %9s\n", "Scenario", "Call", "Calls", "Success", "Wrong",
+           "p50 ms", "p90 ms", "p99 ms", "max ms", "fail ms");
+    printf("-----------------------------------------------------------------------------------------------------\n");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        if (strstr(scenarios[i].name, filter) == nullptr)
+            continue;
+
+        for (size_t j = 0; j < sizeof(operations) / sizeof(operations[0]); j++)
+            run(scenarios[i], operations[j], trials);
+    }
+
+    return 0;
+}
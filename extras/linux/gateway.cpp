@@ -0,0 +1,169 @@
+/**
+  * @file       gateway.cpp
+  * @brief      Example Linux gateway: configure several SEN0395s over USB-serial, then follow them all from one thread
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * Each sensor is configured through DFR_Radar to push its detection status ($JYBSS) as soon as
+  * it changes, then every port is handed to a DFR_RadarEpoll, which reports each change.  A
+  * sensor whose port goes away (its adapter unplugged) is reported, then opened and configured
+  * again every few seconds until it's back.
+  *
+  *     gateway /dev/ttyUSB0 [/dev/ttyUSB1 ...]
+  *
+  * With no hardware at hand, run `sensor-sim 8` and pass this the devices it prints.
+  */
+
+#include <Arduino.h>
+#include <DFR_Radar.h>
+#include <DFR_RadarPointCloud.h>
+#include <DFR_RadarPosix.h>
+#include <DFR_RadarShared.h>
+
+
+struct GatewayTraits : DFR_RadarTraits {
+    typedef DFR_RadarPosixTransport Transport;
+};
+
+typedef DFR_RadarT<GatewayTraits> Sensor;
+
+static constexpr int maxSensors = 32;
+
+// Three pushes missed
+static constexpr unsigned long silenceLimit = 3000;
+
+// Configuring a sensor that doesn't answer holds up all the others, so don't try too often
+static constexpr unsigned long reconnectInterval = 5000;
+
+static DFR_RadarSharedPublisher publisher;
+
+struct Gateway {
+    Gateway() : cloud(points, DFR_RadarSharedState::maxPoints) {}
+
+    uint16_t index;
+    const char *path;
+    bool presence;
+    Sensor::HealthState health;
+    unsigned long heard;
+    unsigned long connected;
+
+    DFR_RadarTty port;
+
+    DFR_RadarPoint points[DFR_RadarSharedState::maxPoints];
+    DFR_RadarPointCloud cloud;
+};
+
+static void setHealth(Gateway &gateway, const Sensor::HealthState health) {
+    if (health == gateway.health)
+        return;
+
+    gateway.health = health;
+    publisher.publishHealth(gateway.index, health);
+    printf("%10lu  %s  %s\n", millis(), gateway.path, health == Sensor::Healthy ? "responding" : "silent");
+    fflush(stdout);
+}
+
+// Open the sensor's port, and have it push its detection status on every change, and once a second otherwise
+static bool connect(Gateway &gateway) {
+    gateway.connected = millis();
+
+    if (!gateway.port.begin(gateway.path))
+        return false;
+
+    Sensor sensor(&gateway.port);
+    if (!sensor.configureUartDetectionOutput(true, true, 1)) {
+        gateway.port.end();
+        return false;
+    }
+
+    gateway.heard = millis();
+    return true;
+}
+
+static void onLine(DFR_RadarTty &, const char *line, void *context) {
+    Gateway &gateway = *static_cast<Gateway *>(context);
+    const size_t length = strlen(line);
+
+    gateway.heard = millis();
+    setHealth(gateway, Sensor::Healthy);
+
+    // Everything that isn't a valid status or point cloud frame (command echoes, responses, ...) is ignored
+    DFR_RadarStatus status;
+    if (!DFR_RadarStatus::parse(line, length, status)) {
+        if (gateway.cloud.decode(line, length))
+            publisher.publishFrame(gateway.index, gateway.cloud.getPoints(), gateway.cloud.getCount());
+        return;
+    }
+
+    if (status.presence == gateway.presence)
+        return;
+
+    gateway.presence = status.presence;
+    publisher.publishPresence(gateway.index, status.presence);
+    printf("%10lu  %s  %s\n", millis(), gateway.path, status.presence ? "presence" : "clear");
+    fflush(stdout);
+}
+
+static void onHangup(DFR_RadarTty &port, void *context) {
+    Gateway &gateway = *static_cast<Gateway *>(context);
+
+    port.end();
+
+    // Reported even if it had already gone quiet
+    gateway.health = Sensor::Unhealthy;
+    publisher.publishHealth(gateway.index, Sensor::Unhealthy);
+    printf("%10lu  %s  disconnected\n", millis(), gateway.path);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    const char *segment = nullptr;
+    int first = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-s") == 0) {
+        segment = argv[2];
+        first = 3;
+    }
+
+    if (argc - first < 1 || argc - first > maxSensors) {
+        fprintf(stderr, "usage: %s [-s /segment] <tty> [tty ...] (up to %d)\n", argv[0], maxSensors);
+        return 1;
+    }
+
+    // Publishing to no segment does nothing, so the rest needn't check
+    if (segment != nullptr && !publisher.begin(segment, argc - first)) {
+        perror(segment);
+        return 1;
+    }
+
+    static Gateway gateways[maxSensors];
+    DFR_RadarEpoll<maxSensors> epoll;
+
+    for (int i = first; i < argc; i++) {
+        Gateway &gateway = gateways[i - first];
+        gateway.index = i - first;
+        gateway.path = argv[i];
+
+        if (!connect(gateway)) {
+            fprintf(stderr, "%s: failed to open or configure the sensor\n", gateway.path);
+            return 1;
+        }
+
+        epoll.add(gateway.port, onLine, &gateway, onHangup);
+    }
+
+    // Wake at least once a second to notice sensors that have gone quiet, or can be reopened
+    while (epoll.wait(1000) >= 0)
+        for (int i = 0; i < argc - first; i++) {
+            Gateway &gateway = gateways[i];
+
+            if (gateway.port.fd() < 0 && millis() - gateway.connected >= reconnectInterval && connect(gateway))
+                epoll.add(gateway.port, onLine, &gateway, onHangup);
+
+            if (millis() - gateway.heard > silenceLimit)
+                setHealth(gateway, Sensor::Unhealthy);
+        }
+
+    perror("epoll_wait");
+    return 1;
+}
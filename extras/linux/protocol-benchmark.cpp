@@ -0,0 +1,207 @@
+/**
+  * @file       protocol-benchmark.cpp
+  * @brief      Microbenchmarks for DFR_Radar's protocol hot paths, run natively against in-memory sensors
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * Each benchmark drives the real driver through a public method, talking to a
+  * DFR_RadarMemoryPort that answers with a recorded reply, so only the library's own work is
+  * measured: writing the command, filtering the response lines, and parsing what's wanted
+  * (a setting, the presence status, or a point cloud frame with and without a filter).
+  * Every benchmark is repeated until it has run for at least `minTime`, then reports:
+  *
+  *   - time per operation in nanoseconds
+  *   - bytes per second (written to the sensor plus read back)
+  *   - heap allocations per operation (should always be 0)
+  *
+  * Run it before and after a change to any of these paths, on an otherwise idle machine.
+  *
+  *     protocol-benchmark [filter]
+  */
+
+#include <Arduino.h>
+#include <DFR_Radar.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+
+// Count every allocation the process makes; the driver itself should never make any
+static unsigned long allocations = 0;
+
+#if defined(__GLIBC__)
+extern "C" {
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+
+    void *malloc(size_t size) {
+        allocations++;
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t count, size_t size) {
+        allocations++;
+        return __libc_calloc(count, size);
+    }
+
+    void *realloc(void *pointer, size_t size) {
+        allocations++;
+        return __libc_realloc(pointer, size);
+    }
+}
+#endif
+
+static constexpr double minTime = 0.5;
+
+static double seconds() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief One benchmark: a sensor answering with `reply`, and the operation to time
+ */
+struct ProtocolBenchmark {
+    const char *name;
+    const char *reply;
+    void (*setUp)(DFR_Radar &sensor);
+    bool (*operation)(DFR_Radar &sensor);
+};
+
+// sendCommand(): write a command, then skip its echo and the prompt until "Done"
+static bool sendCommand(DFR_Radar &sensor) {
+    return sensor.reboot();
+}
+
+// getConfig(): find the "Response" line and split and convert its fields
+static bool getConfig(DFR_Radar &sensor) {
+    float minimum, maximum;
+    return sensor.getDetectionRange(minimum, maximum);
+}
+
+// readPresence(): read the lines after "getOutput 1" and parse the $JYBSS frame in them
+static bool readPresence(DFR_Radar &sensor) {
+    bool presence;
+    return sensor.readPresence(presence);
+}
+
+static bool readStatus(DFR_Radar &sensor) {
+    DFR_RadarStatus status;
+    return sensor.readStatus(status);
+}
+
+// Setters inside configBegin()/configEnd() skip the stop/start around each command, which
+// leaves validating, formatting and one sendCommand()
+static void configBegin(DFR_Radar &sensor) {
+    sensor.configBegin();
+}
+
+static bool setSensitivity(DFR_Radar &sensor) {
+    return sensor.setSensitivity(7);
+}
+
+static bool setDetectionRange(DFR_Radar &sensor) {
+    return sensor.setDetectionRange(0.5, 6.25);
+}
+
+static bool setUartOutput(DFR_Radar &sensor) {
+    const float arguments[] = { 1, 1, 1, 0.025 };
+    return sensor.set(DFR_RadarCommands::setUartOutput, arguments);
+}
+
+// readPointCloud(): a frame of 8 points, all kept, or filtered down to the 2 strongest nearby ones
+#define POINT_CLOUD_REPLY "getOutput 2\r\nDone\r\nleapMMW:/>" \
+    "$JYRPO,8,1,0.812,31.4,-0.125*\r\n$JYRPO,8,2,1.524,38.6,-0.310*\r\n$JYRPO,8,3,2.200,12.5,0.000*\r\n" \
+    "$JYRPO,8,4,2.975,22.8,0.450*\r\n$JYRPO,8,5,3.410,18.1,0.020*\r\n$JYRPO,8,6,4.630,9.7,-0.780*\r\n" \
+    "$JYRPO,8,7,5.205,7.2,0.115*\r\n$JYRPO,8,8,6.480,5.0,0.000*\r\n"
+
+static DFR_RadarPoint points[8];
+static DFR_RadarPointCloud cloud(points, 8);
+
+static void keepAll(DFR_Radar &) {
+    cloud.setFilter(DFR_RadarPointFilter());
+}
+
+static void keepNearest(DFR_Radar &) {
+    DFR_RadarPointFilter filter;
+    filter.maxRange = 3000;
+    filter.minMagnitude = 150;
+    filter.maxPoints = 2;
+    cloud.setFilter(filter);
+}
+
+static bool readPointCloud(DFR_Radar &sensor) {
+    return sensor.readPointCloud(cloud);
+}
+
+static const ProtocolBenchmark benchmarks[] = {
+    { "sendCommand/reboot",      "resetSystem 0\r\nDone\r\nleapMMW:/>",                             nullptr,     sendCommand },
+    { "getConfig/getRange",      "getRange\r\nResponse 0.500 6.250\r\nDone\r\nleapMMW:/>",          nullptr,     getConfig },
+    { "readPresence",            "getOutput 1\r\nDone\r\nleapMMW:/>$JYBSS,1, , , *\r\n",            nullptr,     readPresence },
+    { "readStatus",              "getOutput 1\r\nDone\r\nleapMMW:/>$JYBSS,1, , , *\r\n",            nullptr,     readStatus },
+    { "set/setSensitivity",      "setSensitivity 7\r\nDone\r\nleapMMW:/>",                          configBegin, setSensitivity },
+    { "set/setRange",            "setRange 0.500 6.250\r\nDone\r\nleapMMW:/>",                      configBegin, setDetectionRange },
+    { "set/setUartOutput",       "setUartOutput 1 1 1 0.025\r\nDone\r\nleapMMW:/>",                 configBegin, setUartOutput },
+    { "readPointCloud/all",      POINT_CLOUD_REPLY,                                                 keepAll,     readPointCloud },
+    { "readPointCloud/filtered", POINT_CLOUD_REPLY,                                                 keepNearest, readPointCloud }
+};
+
+static bool run(const ProtocolBenchmark &benchmark) {
+    DFR_RadarMemoryPort port(benchmark.reply);
+    DFR_Radar sensor(&port);
+
+    if (benchmark.setUp != nullptr)
+        benchmark.setUp(sensor);
+
+    // Make sure it works at all, and warm up the caches
+    if (!benchmark.operation(sensor)) {
+        printf("%-24s failed\n", benchmark.name);
+        return false;
+    }
+
+    unsigned long iterations = 1;
+    double elapsed = 0;
+    size_t bytes = 0;
+    unsigned long allocated = 0;
+
+    // Grow the batch until it takes long enough to time reliably
+    while (true) {
+        const size_t writtenBefore = port.getWritten();
+        const unsigned long allocationsBefore = allocations;
+        const double start = seconds();
+
+        for (unsigned long i = 0; i < iterations; i++)
+            benchmark.operation(sensor);
+
+        elapsed = seconds() - start;
+        allocated = allocations - allocationsBefore;
+        bytes = port.getWritten() - writtenBefore + iterations * port.getReplyLength();
+
+        if (elapsed >= minTime)
+            break;
+
+        iterations = elapsed < minTime / 100 ? iterations * 10 : static_cast<unsigned long>(iterations * minTime * 1.2 / elapsed) + 1;
+    }
+
+    printf("%-24s %10.1f %12lu %10.1f MB/s %8.2f\n", benchmark.name, elapsed * 1e9 / iterations, iterations,
+           bytes / elapsed / 1e6, static_cast<double>(allocated) / iterations);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *filter = argc > 1 ? argv[1] : "";
+    bool success = true;
+
+    printf("%-24s %10s %12s %15s %8s\n", "Benchmark", "ns/op", "Iterations", "Throughput", "Allocs");
+    printf("------------------------------------------------------------------------------\n");
+
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+        if (strstr(benchmarks[i].name, filter) != nullptr)
+            success = run(benchmarks[i]) && success;
+    }
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+/**
+  * @file       scan-benchmark.cpp
+  * @brief      Measures how fast received data can be split into lines and frames, a byte at a time versus with DFR_RadarScan
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * Fills a buffer with typical sensor traffic (status frames, command echoes, prompts and long
+  * comma-separated data lines), then scans it repeatedly on one core: once looking at every
+  * byte in turn, the way the receive loops used to, and once with `DFR_RadarScan`.  Prints
+  * the throughput of each in MB/s.
+  *
+  *     scan-benchmark [megabytes]
+  */
+
+#include <Arduino.h>
+#include <DFR_RadarScan.h>
+
+
+static constexpr int passes = 5;
+
+static double seconds() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static size_t fill(char *buffer, const size_t size) {
+    static const char *const lines[] = {
+        "$JYBSS,1, , , *\r\n",
+        "$JYBSS,0, , , *\r\n",
+        "getOutput 1\r\nDone\r\nleapMMW:/>",
+        "$DFDMD,2,1,0.84,1.27,-0.36,0.12,0.95,1.81,0.44,-0.07,1.02,2.33,0.51,0.09,1.15*\r\n",
+        "Response 0.000 6.000\r\n"
+    };
+
+    size_t length = 0;
+    for (unsigned i = 0; ; i++) {
+        const char *line = lines[i * 7 % (sizeof(lines) / sizeof(lines[0]))];
+        const size_t lineLength = strlen(line);
+
+        if (length + lineLength > size)
+            return length;
+
+        memcpy(buffer + length, line, lineLength);
+        length += lineLength;
+    }
+}
+
+// Lines, the way the receive loops used to find them
+static size_t linesBytewise(const char *data, const size_t length) {
+    size_t lines = 0, characters = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        const char c = data[i];
+
+        if (c == '\r')
+            continue;
+
+        if (c == '\n')
+            lines++;
+        else
+            characters++;
+    }
+
+    return lines + characters;
+}
+
+static size_t linesScanned(const char *data, const size_t length) {
+    size_t lines = 0, characters = 0;
+    const char *position = data;
+    const char *end = data + length;
+
+    while (position < end) {
+        const char *delimiter = DFR_RadarScan::findEither(position, end - position, '\r', '\n');
+        if (delimiter == nullptr) {
+            characters += end - position;
+            break;
+        }
+
+        characters += delimiter - position;
+        if (*delimiter == '\n')
+            lines++;
+
+        position = delimiter + 1;
+    }
+
+    return lines + characters;
+}
+
+// Frames: every '$', then the '*' that ends it
+static size_t framesBytewise(const char *data, const size_t length) {
+    size_t frames = 0;
+    bool inFrame = false;
+
+    for (size_t i = 0; i < length; i++) {
+        if (!inFrame && data[i] == '$') {
+            inFrame = true;
+        } else if (inFrame && data[i] == '*') {
+            inFrame = false;
+            frames++;
+        }
+    }
+
+    return frames;
+}
+
+static size_t framesScanned(const char *data, const size_t length) {
+    size_t frames = 0;
+    const char *position = data;
+    const char *end = data + length;
+
+    while (true) {
+        const char *start = DFR_RadarScan::find(position, end - position, '$');
+        if (start == nullptr)
+            break;
+
+        const char *stop = DFR_RadarScan::find(start + 1, end - start - 1, '*');
+        if (stop == nullptr)
+            break;
+
+        frames++;
+        position = stop + 1;
+    }
+
+    return frames;
+}
+
+static void measure(const char *name, size_t (*scan)(const char *, size_t), const char *data, const size_t length, size_t &result) {
+    double best = 1e9;
+
+    for (int i = 0; i < passes; i++) {
+        const double start = seconds();
+        result = scan(data, length);
+        const double elapsed = seconds() - start;
+
+        if (elapsed < best)
+            best = elapsed;
+    }
+
+    printf("  %-10s %9.1f MB/s\n", name, length / best / 1e6);
+}
+
+int main(int argc, char **argv) {
+    const size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 64;
+    if (!megabytes) {
+        fprintf(stderr, "usage: %s [megabytes]\n", argv[0]);
+        return 1;
+    }
+
+    const size_t size = megabytes << 20;
+    char *data = static_cast<char *>(malloc(size));
+    if (data == nullptr) {
+        perror("malloc");
+        return 1;
+    }
+
+    const size_t length = fill(data, size);
+    size_t bytewise, scanned;
+
+    printf("DFR_RadarScan: %s, %zu MB of sensor traffic, best of %d\n\n", DFR_RadarScan::method, length >> 20, passes);
+
+    printf("Lines (\\r and \\n):\n");
+    measure("bytewise", linesBytewise, data, length, bytewise);
+    measure("scan", linesScanned, data, length, scanned);
+
+    if (bytewise != scanned) {
+        fprintf(stderr, "mismatch: %zu != %zu\n", bytewise, scanned);
+        return 1;
+    }
+
+    printf("Frames ($ ... *):\n");
+    measure("bytewise", framesBytewise, data, length, bytewise);
+    measure("scan", framesScanned, data, length, scanned);
+
+    if (bytewise != scanned) {
+        fprintf(stderr, "mismatch: %zu != %zu\n", bytewise, scanned);
+        return 1;
+    }
+
+    free(data);
+    return 0;
+}
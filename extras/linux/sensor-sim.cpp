@@ -0,0 +1,332 @@
+/**
+  * @file       sensor-sim.cpp
+  * @brief      Simulated SEN0395 sensors on pseudo-terminals, for trying DFR_Radar on Linux without the hardware
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * Creates one pseudo-terminal per sensor and prints the device each one can be opened at, then
+  * answers commands on all of them from a single thread: command echo and prompt, "Done"/"Error",
+  * `sensorStop`/`sensorStart`, the getters and setters DFR_Radar uses, `getOutput 1`, `getOutput 2`
+  * (a point cloud of someone walking back and forth), and pushed `$JYBSS` status while output is
+  * enabled.  Each sensor's presence flips every few seconds.
+  *
+  *     sensor-sim [count]
+  */
+
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+
+static constexpr int maxSensors = 64;
+static constexpr size_t lineLength = 64;
+
+struct SimulatedSensor {
+    int master;
+    int slave;
+    char line[lineLength];
+    size_t length;
+
+    bool started;
+    bool echo;
+    bool presence;
+    unsigned long presenceSince;
+    unsigned long presencePeriod;
+
+    // Detection output ($JYBSS): setUartOutput 1 <enable> <push> <period>
+    bool outputEnabled;
+    bool outputOnChange;
+    float outputPeriod;
+    unsigned long lastOutput;
+
+    char range[2][16];
+    char latency[2][16];
+    char inhibit[16];
+    unsigned sensitivity;
+};
+
+static unsigned long now() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000UL + time.tv_nsec / 1000000UL;
+}
+
+static void send(const SimulatedSensor &sensor, const char *text) {
+    const size_t length = strlen(text);
+    if (write(sensor.master, text, length) != static_cast<ssize_t>(length))
+        perror("write");
+}
+
+static void sendLine(const SimulatedSensor &sensor, const char *text) {
+    send(sensor, text);
+    send(sensor, "\r\n");
+}
+
+static void sendStatus(SimulatedSensor &sensor) {
+    sendLine(sensor, sensor.presence ? "$JYBSS,1, , , *" : "$JYBSS,0, , , *");
+    sensor.lastOutput = now();
+}
+
+static void sendPointCloud(const SimulatedSensor &sensor) {
+    if (!sensor.presence) {
+        sendLine(sensor, "$JYRPO,0, , , *");
+        return;
+    }
+
+    // Someone walking between 1 and 5 m, and a weaker reflection that stays put
+    const double phase = (now() - sensor.presenceSince) / 4000.0;
+    const double range = 3 + 2 * sin(phase);
+    const double velocity = 2 * cos(phase) / 4;
+    char point[lineLength];
+
+    snprintf(point, sizeof(point), "$JYRPO,2,1,%.3f,%.1f,%.3f*", range, 40 - 4 * range, velocity);
+    sendLine(sensor, point);
+    sendLine(sensor, "$JYRPO,2,2,2.200,12.5,0.000*");
+}
+
+static bool create(SimulatedSensor &sensor, const int index) {
+    memset(&sensor, 0, sizeof(sensor));
+
+    sensor.master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (sensor.master < 0 || grantpt(sensor.master) != 0 || unlockpt(sensor.master) != 0)
+        return false;
+
+    // Raw on both ends, so nothing gets translated or echoed by the terminal itself
+    termios settings;
+    tcgetattr(sensor.master, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(sensor.master, TCSANOW, &settings);
+
+    // Keep a handle on the other end too; otherwise the master hangs up whenever no one has it open
+    sensor.slave = open(ptsname(sensor.master), O_RDWR | O_NOCTTY);
+    if (sensor.slave < 0)
+        return false;
+
+    tcgetattr(sensor.slave, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(sensor.slave, TCSANOW, &settings);
+
+    fcntl(sensor.master, F_SETFL, fcntl(sensor.master, F_GETFL) | O_NONBLOCK);
+
+    // Factory defaults
+    sensor.started = true;
+    sensor.echo = true;
+    sensor.outputEnabled = true;
+    sensor.outputPeriod = 1;
+    sensor.sensitivity = 7;
+    strcpy(sensor.range[0], "0.000");
+    strcpy(sensor.range[1], "6.000");
+    strcpy(sensor.latency[0], "0.025");
+    strcpy(sensor.latency[1], "5.000");
+    strcpy(sensor.inhibit, "1.000");
+
+    // Stagger the sensors so they don't all change at once
+    sensor.presencePeriod = 3000 + 700 * index;
+    sensor.presenceSince = now();
+    return true;
+}
+
+/**
+ * @return true if the command was understood and carried out ("Done"), false for "Error"
+ */
+static bool execute(SimulatedSensor &sensor, const char *command) {
+    char name[lineLength] = {0};
+    char arguments[4][16] = {{0}};
+    const int count = sscanf(command, "%63s %15s %15s %15s %15s", name, arguments[0], arguments[1], arguments[2], arguments[3]) - 1;
+    char response[lineLength];
+
+    if (strcmp(name, "sensorStop") == 0) {
+        if (!sensor.started) {
+            sendLine(sensor, "sensor stopped already");
+            return false;
+        }
+        sensor.started = false;
+        return true;
+    }
+
+    if (strcmp(name, "sensorStart") == 0) {
+        if (sensor.started) {
+            sendLine(sensor, "sensor started already");
+            return false;
+        }
+        sensor.started = true;
+        return true;
+    }
+
+    if (strcmp(name, "getOutput") == 0 || strcmp(name, "resetSystem") == 0 || strcmp(name, "resetCfg") == 0)
+        return true;
+
+    if (strcmp(name, "setEcho") == 0 && count == 1) {
+        sensor.echo = atoi(arguments[0]) == 1;
+        return true;
+    }
+
+    if (strncmp(name, "get", 3) == 0) {
+        if (strcmp(name, "getRange") == 0)
+            snprintf(response, sizeof(response), "Response %s %s", sensor.range[0], sensor.range[1]);
+        else if (strcmp(name, "getSensitivity") == 0)
+            snprintf(response, sizeof(response), "Response %u", sensor.sensitivity);
+        else if (strcmp(name, "getLatency") == 0)
+            snprintf(response, sizeof(response), "Response %s %s", sensor.latency[0], sensor.latency[1]);
+        else if (strcmp(name, "getInhibit") == 0)
+            snprintf(response, sizeof(response), "Response %s", sensor.inhibit);
+        else if (strcmp(name, "getEcho") == 0)
+            snprintf(response, sizeof(response), "Response %u", sensor.echo);
+        else if (strcmp(name, "getUartOutput") == 0 && count == 1)
+            snprintf(response, sizeof(response), "Response %s %u %u %.3f", arguments[0], sensor.outputEnabled, sensor.outputOnChange, sensor.outputPeriod);
+        else if (strcmp(name, "getGpioMode") == 0 && count == 1)
+            snprintf(response, sizeof(response), "Response %s 1", arguments[0]);
+        else if (strcmp(name, "getLedMode") == 0 && count == 1)
+            snprintf(response, sizeof(response), "Response %s 0", arguments[0]);
+        else if (strcmp(name, "getHWV") == 0)
+            snprintf(response, sizeof(response), "HardwareVersion:Simulated_SEN0395");
+        else if (strcmp(name, "getSWV") == 0)
+            snprintf(response, sizeof(response), "SoftwareVersion:sensor-sim");
+        else
+            return false;
+
+        sendLine(sensor, response);
+        return true;
+    }
+
+    // Everything else changes the configuration, which the sensor only allows while stopped
+    if (sensor.started)
+        return false;
+
+    if (strcmp(name, "saveConfig") == 0)
+        return true;
+
+    if (strcmp(name, "setRange") == 0 && count == 2) {
+        snprintf(sensor.range[0], sizeof(sensor.range[0]), "%s", arguments[0]);
+        snprintf(sensor.range[1], sizeof(sensor.range[1]), "%s", arguments[1]);
+        return true;
+    }
+
+    if (strcmp(name, "setSensitivity") == 0 && count == 1) {
+        sensor.sensitivity = atoi(arguments[0]);
+        return true;
+    }
+
+    if (strcmp(name, "setLatency") == 0 && count == 2) {
+        snprintf(sensor.latency[0], sizeof(sensor.latency[0]), "%s", arguments[0]);
+        snprintf(sensor.latency[1], sizeof(sensor.latency[1]), "%s", arguments[1]);
+        return true;
+    }
+
+    if (strcmp(name, "setInhibit") == 0 && count == 1) {
+        snprintf(sensor.inhibit, sizeof(sensor.inhibit), "%s", arguments[0]);
+        return true;
+    }
+
+    if (strcmp(name, "setUartOutput") == 0 && count >= 2) {
+        if (atoi(arguments[0]) == 1) {
+            sensor.outputEnabled = atoi(arguments[1]) == 1;
+            sensor.outputOnChange = count >= 3 && atoi(arguments[2]) == 1;
+            sensor.outputPeriod = count == 4 ? strtof(arguments[3], nullptr) : 1;
+        }
+        return true;
+    }
+
+    return strcmp(name, "outputLatency") == 0 || strcmp(name, "setGpioMode") == 0 || strcmp(name, "setLedMode") == 0;
+}
+
+static void receive(SimulatedSensor &sensor) {
+    char chunk[lineLength];
+    ssize_t got;
+
+    while ((got = read(sensor.master, chunk, sizeof(chunk))) > 0) {
+        for (ssize_t i = 0; i < got; i++) {
+            const char c = chunk[i];
+
+            if (c == '\r')
+                continue;
+
+            if (c != '\n') {
+                if (sensor.length < lineLength - 1)
+                    sensor.line[sensor.length++] = c;
+                continue;
+            }
+
+            sensor.line[sensor.length] = '\0';
+            sensor.length = 0;
+
+            if (sensor.echo)
+                sendLine(sensor, sensor.line);
+
+            const bool done = execute(sensor, sensor.line);
+            sendLine(sensor, done ? "Done" : "Error");
+
+            if (sensor.echo)
+                send(sensor, "leapMMW:/>");
+
+            if (done && strcmp(sensor.line, "getOutput 1") == 0)
+                sendStatus(sensor);
+
+            if (done && strcmp(sensor.line, "getOutput 2") == 0)
+                sendPointCloud(sensor);
+        }
+    }
+}
+
+static void simulate(SimulatedSensor &sensor) {
+    const unsigned long time = now();
+    bool changed = false;
+
+    if (time - sensor.presenceSince >= sensor.presencePeriod) {
+        sensor.presence = !sensor.presence;
+        sensor.presenceSince = time;
+        changed = true;
+    }
+
+    // Pushed output only happens while running, and never in passive mode (period > 1500)
+    if (!sensor.started || !sensor.outputEnabled || sensor.outputPeriod > 1500)
+        return;
+
+    if ((changed && sensor.outputOnChange) || time - sensor.lastOutput >= sensor.outputPeriod * 1000)
+        sendStatus(sensor);
+}
+
+int main(int argc, char **argv) {
+    const int count = argc > 1 ? atoi(argv[1]) : 1;
+    if (count < 1 || count > maxSensors) {
+        fprintf(stderr, "usage: %s [count (1-%d)]\n", argv[0], maxSensors);
+        return 1;
+    }
+
+    static SimulatedSensor sensors[maxSensors];
+    pollfd watches[maxSensors];
+
+    for (int i = 0; i < count; i++) {
+        if (!create(sensors[i], i)) {
+            perror("posix_openpt");
+            return 1;
+        }
+
+        watches[i].fd = sensors[i].master;
+        watches[i].events = POLLIN;
+        printf("%s\n", ptsname(sensors[i].master));
+    }
+
+    fflush(stdout);
+
+    while (true) {
+        if (poll(watches, count, 10) < 0 && errno != EINTR) {
+            perror("poll");
+            return 1;
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (watches[i].revents & POLLIN)
+                receive(sensors[i]);
+
+            simulate(sensors[i]);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/**
+  * @file       shared-reader.cpp
+  * @brief      Prints the sensor states a gateway publishes with DFR_RadarSharedPublisher
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * Prints every sensor's state once, or with `-w`, again whenever it's published.  Watching polls
+  * each sensor's version every few milliseconds, and only copies the states that changed; any
+  * number of these can run beside the gateway without slowing it down.
+  *
+  *     shared-reader [-w] /segment
+  */
+
+#include <Arduino.h>
+#include <DFR_RadarShared.h>
+#include <time.h>
+
+
+static constexpr long pollInterval = 5;
+
+static const char *const healthNames[] = { "healthy", "degraded", "unhealthy", "recovering" };
+
+static void print(const uint16_t sensor, const DFR_RadarSharedState &state) {
+    printf("%10llu  %3u  %-8s  %-10s  %2u points", static_cast<unsigned long long>(state.updated), sensor,
+           state.presence ? "presence" : "clear", state.health < 4 ? healthNames[state.health] : "?", state.pointCount);
+
+    for (uint8_t i = 0; i < state.pointCount && i < DFR_RadarSharedState::maxPoints; i++)
+        printf("  %u.%03u m %+d mm/s", state.points[i].range / 1000, state.points[i].range % 1000, state.points[i].velocity);
+
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    const bool watch = argc == 3 && strcmp(argv[1], "-w") == 0;
+
+    if (argc != 2 && !watch) {
+        fprintf(stderr, "usage: %s [-w] /segment\n", argv[0]);
+        return 1;
+    }
+
+    DFR_RadarSharedReader reader;
+    if (!reader.begin(argv[argc - 1])) {
+        fprintf(stderr, "%s: no segment published there, or not ready\n", argv[argc - 1]);
+        return 1;
+    }
+
+    const uint16_t sensors = reader.getSensorCount();
+    static uint32_t versions[65536];
+
+    do {
+        for (uint16_t i = 0; i < sensors; i++) {
+            const uint32_t version = reader.getVersion(i);
+            if (version == versions[i])
+                continue;
+
+            DFR_RadarSharedState state;
+            if (!reader.read(i, state))
+                continue;
+
+            versions[i] = version;
+            print(i, state);
+        }
+
+        fflush(stdout);
+
+        if (watch) {
+            const timespec interval = { 0, pollInterval * 1000000 };
+            nanosleep(&interval, nullptr);
+        }
+    } while (watch);
+
+    return 0;
+}
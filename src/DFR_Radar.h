@@ -16,15 +16,61 @@
 #define DFR_Radar_H_
 
 #include <Arduino.h>
+#include <DFR_RadarTraits.h>
+#include <DFR_RadarCommands.h>
+#include <DFR_RadarStatus.h>
+#include <DFR_RadarPoint.h>
+#include <DFR_RadarPointCloud.h>
+#include <DFR_RadarScan.h>
 
 
-class DFR_Radar {
+/**
+ * @brief Driver for the SEN0395, built according to a compile-time policy.
+ *
+ * @tparam Traits  Buffer sizes, optional features and logging; see `DFR_RadarTraits`.
+ *                 Most sketches simply use `DFR_Radar`, which is this with the defaults.
+ */
+template<typename Traits = DFR_RadarTraits>
+class DFR_RadarT {
 public:
+    /**
+     * @brief How well the sensor has been responding lately
+     */
+    enum HealthState : uint8_t {
+        Healthy,     // Responding normally
+        Degraded,    // Some recent requests went unanswered, but not enough to give up on it
+        Unhealthy,   // Too many consecutive unanswered requests; calls fail fast until recovery succeeds
+        Recovering   // A recovery attempt (reboot, then re-apply the cached configuration) is in progress
+    };
+
+    /**
+     * @brief Called whenever the sensor's health state changes
+     *
+     * @param sensor   The sensor whose health changed
+     * @param previous The state it was in
+     * @param current  The state it is in now
+     */
+    typedef void (*HealthCallback)(const DFR_RadarT &sensor, HealthState previous, HealthState current);
+
+    /**
+     * @brief What a tap mirrors of the bytes received from the sensor
+     */
+    enum TapMode : uint8_t {
+        TapEverything,  // Every byte, as received
+        TapFrames       // Only $JYBSS and $JYRPO frames, from "$" to the end of the line
+    };
+
+    /**
+     * @brief The kind of port the sensor is attached to; `Stream` unless the policy's
+     *        `Transport` says otherwise
+     */
+    typedef typename Traits::Transport::Port Port;
+
     /**
       * @brief Constructor
-      * @param s Stream Software serial port interface
+      * @param s Serial port (hardware or software) the sensor is attached to
       */
-    explicit DFR_Radar(Stream *s);
+    explicit DFR_RadarT(Port *s);
 
     /**
      * @brief Not currently implemented
@@ -33,12 +79,50 @@ public:
      */
     bool begin(void);
 
+    /**
+     * @brief Bring the sensor to a configuration profile, or confirm it already holds it.
+     *
+     * @details A fingerprint of the profile is compared with the one stored after the last
+     *          successful call.  If they match, each setting is read back from the sensor (no
+     *          stop, no flash write) and, if they all agree, nothing else is done: a warm start
+     *          after the MCU reset but the sensor didn't.  Otherwise, the sensor is reset to its
+     *          factory settings and the whole profile is applied and saved in one go.
+     *
+     *              const DFR_RadarCommandValues profile[] = {
+     *                  { &DFR_RadarCommands::setRange,       { 0, 3 } },
+     *                  { &DFR_RadarCommands::setSensitivity, { 7 } }
+     *              };
+     *
+     *              sensor.begin( profile, 2, storedFingerprint );
+     *
+     * @note Keep the fingerprint somewhere that survives a reset of the MCU but not of the
+     *       sensor's configuration by anyone else: RTC memory, NVS/EEPROM, or a `.noinit` variable.
+     *       Settings without a getter (`outputLatency`) can't be read back, so they're only
+     *       covered by the fingerprint.
+     *
+     * @param profile     The settings, in the order they should be applied
+     * @param count       Number of settings
+     * @param fingerprint The fingerprint stored last time (anything, e.g. 0, if none); on
+     *                    success, this is the profile's fingerprint, to be stored for next time
+     *
+     * @return true if the sensor now holds the profile; false if a setting is invalid or
+     *         applying the profile failed (`fingerprint` is then 0)
+     */
+    bool begin(const DFR_RadarCommandValues profile[], uint8_t count, uint32_t &fingerprint);
+
+    /**
+     * @brief Check whether the last `begin()` with a profile found it already in place
+     *
+     * @return true if the sensor was only checked, not reconfigured
+     */
+    bool isWarmStart(void) const { return warmStart; }
+
     /**
      * @brief Set the serial port to use for communicating with the sensor
      *
      * @param s  The serial port to use
      */
-    void setStream(Stream *s);
+    void setStream(Port *s);
 
     /**
      * @brief Check if the sensor is ready to accept commands
@@ -149,6 +233,75 @@ public:
      */
     bool readPresence(bool &presence) const;
 
+    /**
+     * @brief Read the sensor's whole detection status, checked field by field
+     *
+     * @param status Filled in with every field, when it was received and its sequence number
+     *
+     * @return true if a valid status frame was received;
+     *         false if reading failed or the frame was malformed (see `getMalformedCount()`)
+     */
+    bool readStatus(DFR_RadarStatus &status) const;
+
+    /**
+     * @brief Decode the detection status the sensor pushes by itself (`configureUartDetectionOutput(true, true, period)`),
+     *        without sending anything
+     *
+     * @details Reads only while data is arriving, and returns at the first valid status frame;
+     *          call it from `loop()`.  Other lines are dropped, so don't mix it with
+     *          `receivePointCloud()` on the same sensor.
+     *
+     * @param status Filled in with every field, when it was received and its sequence number
+     *
+     * @return true if a valid status frame was received
+     */
+    bool receiveStatus(DFR_RadarStatus &status) const;
+
+    /**
+     * @brief Read one frame of the sensor's point cloud ($JYRPO)
+     *
+     * @note Enable the point cloud output first (`configureUartPointCloudOutput(true)`).
+     *       Past `size` points, the strongest ones are kept.
+     *
+     * @param points Filled in with the frame's points, in the order received
+     * @param size   Most points `points` can hold
+     * @param count  Set to the number of points filled in
+     *
+     * @return true if a whole frame was received (possibly without points);
+     *         false if reading failed, or timed out partway through a frame
+     */
+    bool readPointCloud(DFR_RadarPoint points[], uint8_t size, uint8_t &count) const;
+
+    /**
+     * @brief Read one frame of the sensor's point cloud ($JYRPO) into a decoder, which keeps
+     *        only the points its filter wants (see `DFR_RadarPointCloud`)
+     *
+     * @param cloud The decoder; the points are in `cloud.getPoints()`
+     *
+     * @return true if a whole frame was received and kept;
+     *         false if reading failed, timed out, or the frame was skipped by decimation
+     */
+    bool readPointCloud(DFR_RadarPointCloud &cloud) const;
+
+    /**
+     * @brief Decode point cloud lines the sensor pushes by itself (`configureUartPointCloudOutput(true, true, period)`),
+     *        without sending anything
+     *
+     * @details Reads only while data is arriving, and returns at the end of each frame kept;
+     *          call it from `loop()`.  Frames skipped by decimation are read no further than
+     *          their point numbers.
+     *
+     * @param cloud The decoder; the points are in `cloud.getPoints()`
+     *
+     * @return true if a frame was completed and kept
+     */
+    bool receivePointCloud(DFR_RadarPointCloud &cloud) const;
+
+    /**
+     * @brief Get the number of status and point cloud frames rejected as malformed (truncated, wrong field count, bad characters, ...)
+     */
+    uint32_t getMalformedCount(void) const { return malformedFrames; }
+
     /**
      * @brief Sets a delay between when the presence detection resets and when it can trigger again.
      *
@@ -334,8 +487,9 @@ public:
     /**
      * @brief Restart the sensor's internal software (safe; configuration is not lost or changed).
      *
+     * @return true if the sensor acknowledged the command
      */
-    void reboot(void) const;
+    bool reboot(void);
 
     /**
      * @brief Disable the LED
@@ -390,6 +544,142 @@ public:
      */
     bool configEnd(void);
 
+    /**
+     * @brief Set how many configuration commands may be in flight at once while in
+     *        multi-config mode (between `configBegin()` and `configEnd()`).
+     *
+     * @details With a depth of 2 or more, setters called in multi-config mode only queue their
+     *          command, and the queue is written to the sensor as a pipelined burst: the next
+     *          command is sent as soon as there is room in the window instead of waiting for
+     *          the previous one's response.  Responses are matched back to their commands in
+     *          order by echo and "Done"/"Error".  The queue is sent when it fills up, before
+     *          any getter, and by `configEnd()`, which reports whether any queued command failed.
+     *
+     * @note 0 or 1 disables pipelining (every command waits for its response; the default).
+     *       The upper limit is set by `Traits::pipelineDepth`.
+     *
+     * @param depth  Number of commands in flight, up to `maxPipelineDepth`
+     *
+     * @return false if the depth is invalid (no changes made), true otherwise
+     */
+    bool setPipelineDepth(uint8_t depth);
+
+    /**
+     * @brief Get the number of configuration commands that may be in flight at once
+     *
+     * @return the configured pipeline depth (0 or 1 when pipelining is disabled)
+     */
+    uint8_t getPipelineDepth(void) const { return pipelineDepth; }
+
+    /**
+     * @brief Upper limit for `setPipelineDepth()`; this also sets how many commands can be queued
+     */
+    static constexpr uint8_t maxPipelineDepth = Traits::pipelineDepth;
+
+    /**
+     * @brief Enable or disable write-back mode, which defers saving the configuration to flash.
+     *
+     * @details In write-back mode, setters still apply their change immediately (inside one
+     *          stop/start), but `saveConfig` is held back until no further changes have been made
+     *          for `quietWindow` milliseconds (see `update()`), or until `commit()` is called.
+     *          Several updates in quick succession therefore cost a single flash write.
+     *
+     * @note Changes that haven't been committed are lost if the sensor loses power.  Disabling
+     *       write-back mode commits anything still pending.  Without `Traits::writeBack`, every
+     *       change is saved straight away and enabling it fails.
+     *
+     * @param enable      true to defer saving, false to save after every change (the default)
+     * @param quietWindow Time in milliseconds without changes before pending changes are saved
+     *
+     * @return false if pending changes couldn't be committed while disabling, or write-back mode
+     *         isn't built in; true otherwise
+     */
+    bool setWriteBack(bool enable, unsigned long quietWindow = 5000);
+
+    /**
+     * @brief Check whether write-back mode is enabled
+     *
+     * @return true if saving is deferred
+     */
+    bool isWriteBack(void) const { return Traits::writeBack && deferred.at(0)->enabled; }
+
+    /**
+     * @brief Get the quiet window of write-back mode, as last passed to `setWriteBack()`
+     *
+     * @return the time in milliseconds without changes before pending changes are saved
+     */
+    unsigned long getQuietWindow(void) const { return Traits::writeBack ? deferred.at(0)->quietWindow : 0; }
+
+    /**
+     * @brief Save pending configuration changes to flash now.
+     *
+     * @note Does nothing if there's nothing to save.  In multi-config mode, commands still
+     *       queued are sent first, and nothing is saved if any of them fails.
+     *
+     * @return true if nothing was pending or the configuration was saved;
+     *         false if the sensor failed to stop or re-start, a queued command failed, or the save failed
+     */
+    bool commit(void);
+
+    /**
+     * @brief Check if there are configuration changes that haven't been saved to flash
+     *
+     * @return true if changes are pending
+     */
+    bool isDirty(void) const { return dirty; }
+
+    /**
+     * @brief Housekeeping; call this regularly from `loop()`.
+     *
+     * @details In write-back mode, this commits pending changes once the quiet window has passed;
+     *          if that fails, it tries again after another quiet window.  If the sensor is
+     *          unhealthy, this is also where recovery attempts are made.
+     */
+    void update(void);
+
+    /**
+     * @brief Get the sensor's health, as judged from whether it has been answering requests.
+     *
+     * @note Only requests that go unanswered count against the sensor; an "Error" response
+     *       means it's alive and well.
+     *
+     * @return the current health state
+     */
+    HealthState getHealth(void) const { return Traits::healthMonitor ? monitor.at(0)->health : Healthy; }
+
+    /**
+     * @brief Get how many requests in a row have gone unanswered
+     *
+     * @return the number of consecutive failures
+     */
+    uint8_t getConsecutiveFailures(void) const { return Traits::healthMonitor ? monitor.at(0)->consecutiveFailures : 0; }
+
+    /**
+     * @brief Set how many consecutive unanswered requests mark the sensor as unhealthy.
+     *
+     * @details Once unhealthy, commands, getters and presence reads return false immediately
+     *          instead of waiting out their timeouts, and `update()` attempts to recover the
+     *          sensor: a reboot, then the configuration applied through this library is
+     *          re-applied.  Failed attempts are retried with exponential backoff, starting at
+     *          `minRecoveryBackoff` and doubling up to `maxRecoveryBackoff`.
+     *
+     * @param failures  Number of consecutive failures; 0 disables health monitoring (default is 3)
+     */
+    void setHealthThreshold(uint8_t failures);
+
+    /**
+     * @brief Register a function to be called on every health state change
+     *
+     * @param callback  The function to call, or nullptr to stop reporting
+     */
+    void onHealthChange(HealthCallback callback) {
+        if (Traits::healthMonitor)
+            monitor.at(0)->callback = callback;
+    }
+
+    static constexpr unsigned long minRecoveryBackoff = 1000;
+    static constexpr unsigned long maxRecoveryBackoff = 60000;
+
     /**
      * @brief Restore the sensor configuration to factory default settings.
      *
@@ -416,6 +706,77 @@ public:
      */
     bool getSWVersion(char *version);
 
+    /**
+     * @brief Send any configuration command in `DFR_RadarCommands`, the same way the setters above do
+     *
+     * @note Useful for commands that don't have a setter of their own yet, e.g.
+     *
+     *           const float range[] = { 0.5, 4 };
+     *           sensor.set( DFR_RadarCommands::setRange, range );
+     *
+     * @param command   The command to send
+     * @param arguments One value per argument of the command; each is checked against its range
+     *
+     * @return false if any value is out of range (no changes made), or if the command failed
+     */
+    bool set(const DFR_RadarCommand &command, const float arguments[]);
+
+    /**
+     * @brief Query any setting in `DFR_RadarCommands`, the same way the getters above do
+     *
+     * @param command   The query to send, e.g. `DFR_RadarCommands::getRange`
+     * @param fields    Receives one value per field of the response
+     * @param arguments One value per argument of the query (e.g. which output), if it has any
+     *
+     * @return true if the query was answered with the expected number of fields
+     */
+    bool get(const DFR_RadarCommand &command, float fields[], const float arguments[] = nullptr);
+
+    /**
+     * @brief Mirror the bytes received from the sensor to another port (e.g. USB serial), while
+     *        the library keeps using them as usual
+     *
+     * @details Bytes are written to the tap straight from the receive buffer, as the library
+     *          reads them; call `drain()` while nothing else is reading, so the tap sees
+     *          unsolicited output and the responses to `inject()`ed commands.
+     *
+     * @note Does nothing without `Traits::tap`.
+     *
+     * @param tap  Where to mirror them; nullptr to stop
+     * @param mode Everything, or only the frames
+     */
+    void setTap(Print *tap, TapMode mode = TapEverything);
+
+    /**
+     * @brief Send a command from somewhere else (e.g. a host tool on USB serial) to the sensor,
+     *        between the library's own commands
+     *
+     * @details Configuration commands still queued in multi-config mode are sent first, so the
+     *          host's command can't come between them and their responses.  The reply is read
+     *          before returning, up to the prompt, so it goes to the tap in one piece.
+     *
+     * @note The library doesn't know what the command changed, so e.g. a `sensorStop` from the
+     *       host leaves the sensor stopped until `start()`.
+     *
+     * @param command The whole command, without a line terminator
+     *
+     * @return false if there's no port to send it to, the queued commands couldn't be sent, or
+     *         the sensor didn't answer within `comTimeout`
+     */
+    bool inject(const char *command);
+
+    /**
+     * @brief Read and discard everything received that the library isn't waiting for, so a tap
+     *        sees it
+     *
+     * @details Configuration commands still queued in multi-config mode are sent first, so their
+     *          responses aren't thrown away.
+     *
+     * @note Don't call it when frames are being read with `receivePointCloud()`; that consumes
+     *       (and mirrors) them itself.
+     */
+    void drain(void);
+
     /**
      * @brief Enable or disable USB serial debugging output of sensor data.
      *
@@ -424,15 +785,139 @@ public:
     void setDebug(const bool enable) { debugSerial = enable; }
 
 private:
+    typedef typename Traits::Log Log;
+    typedef typename Traits::Idle Idle;
+
+    /**
+     * @brief Format a value with a number of decimals (or as a whole number if `Traits::floatSupport` is false)
+     *
+     * @param buffer   Store the formatted value
+     * @param size     Size of `buffer`
+     * @param value    The value to format
+     * @param decimals Number of decimals to format it with
+     */
+    static void formatDecimal(char *buffer, size_t size, float value, uint8_t decimals);
+
+    /**
+     * @brief Check a command's arguments against the table and pair them up with it
+     *
+     * @param values    Receives the command and its arguments
+     * @param command   The command to send
+     * @param arguments One value per argument of the command; may be nullptr if it has none
+     *
+     * @return false if any value is out of its range, or isn't whole where it has to be
+     */
+    static bool prepareCommand(DFR_RadarCommandValues &values, const DFR_RadarCommand &command, const float *arguments);
+
+    /**
+     * @brief Write out a command with its arguments, ready to send
+     *
+     * @param buffer Store the command; must hold `commandLength` characters
+     * @param values A command and its arguments, checked by `prepareCommand()`
+     */
+    static void formatCommand(char *buffer, const DFR_RadarCommandValues &values);
+
+    /**
+     * @brief Check whether two commands change the same setting (the same command, with the same
+     *        key arguments), so the later one overrides the earlier one
+     */
+    static bool sameSetting(const DFR_RadarCommandValues &a, const DFR_RadarCommandValues &b);
+
+    /**
+     * @brief Hash (FNV-1a) the commands a profile would send; never 0
+     *
+     * @return 0 if any setting in it is invalid
+     */
+    static uint32_t fingerprintProfile(const DFR_RadarCommandValues profile[], uint8_t count);
+
+    /**
+     * @brief Read back every setting in a profile that has a getter, and compare it with the profile
+     *
+     * @return true if the sensor answered and every setting read back matches
+     */
+    bool holdsProfile(const DFR_RadarCommandValues profile[], uint8_t count);
+
+    /**
+     * @brief Fill in a status frame's receive time, sequence number and timing, from the last line read
+     */
+    void stamp(DFR_RadarStatus &status) const;
+
+    /**
+     * @brief Get when the last line read was requested and received (all 0 without `Traits::timestamps`)
+     */
+    DFR_RadarTiming lineTiming(void) const { return Traits::timestamps ? stamps.at(0)->line : DFR_RadarTiming(); }
+
     /**
      * @brief Read a line (or more) from the UART port
      *
      * @param buffer Store the read data
+     * @param size   Size of `buffer`
      * @param lineCount number of lines to read
      *
+     * @details With `Traits::timestamps`, notes when the first '$' and the last byte were read.
+     *
      * @return length of characters captured
      */
-    size_t readLines(char *buffer, size_t lineCount = 1) const;
+    size_t readLines(char *buffer, size_t size, size_t lineCount = 1) const;
+
+    /**
+     * @brief Read a single line from the UART port, without the line terminator
+     *
+     * @note Waits up to `comTimeout` for each byte.  Anything that doesn't fit in `buffer`
+     *       is dropped, so the next read starts on a fresh line.  With `Traits::timestamps`,
+     *       notes when its '$' and its last byte were read.
+     *
+     * @param buffer Store the line
+     * @param size   Size of `buffer`
+     *
+     * @return length of the line captured
+     */
+    size_t readLine(char *buffer, size_t size) const;
+
+    /**
+     * @brief Check whether there's anything to read, either already in the receive buffer or
+     *        waiting at the port
+     */
+    bool received(void) const;
+
+    /**
+     * @brief Refill the receive buffer from the port once it's been used up
+     *
+     * @return false if it's empty and nothing else has arrived
+     */
+    bool fillReceiveBuffer(void) const;
+
+    /**
+     * @brief Read whatever has arrived at the port into the receive buffer, mirroring it to the tap
+     *
+     * @return the number of bytes read
+     */
+    uint8_t readReceived(void) const;
+
+    /**
+     * @brief Write a received chunk to the tap, or only the parts of it that are frames
+     */
+    void mirror(const char *data, size_t length) const;
+
+    /**
+     * @brief Throw away everything received so far
+     */
+    void discardReceived(void) const;
+
+    /**
+     * @brief Throw away everything received until the sensor has been quiet for `readPacketTimeout`
+     *        (or for up to `comTimeout`, if it never goes quiet), e.g. replies to abandoned commands
+     */
+    void discardUntilQuiet(void) const;
+
+    /**
+     * @brief Read the reply to an `inject()`ed command, so it goes to the tap: up to its "Done"
+     *        or "Error" and the prompt after it (or a quiet `readPacketTimeout`, with echo off),
+     *        for up to `comTimeout`.  Whatever follows the prompt is left for the library.
+     *
+     * @return true if the command was answered
+     */
+    bool readReply(void) const;
 
     /**
      * @brief Executes a command string after first stopping the sensor, then afterwards
@@ -442,19 +927,91 @@ private:
      *          this this method only executes the command string, and `configEnd()`
      *          must be called to save the configuration and re-start the sensor.
      *
-     * @param command A command string generated by one of the configuration methods
+     * @param values A command and its arguments, checked by `prepareCommand()`
      *
      * @return true if command was successful;
      *         false if sensor failed to stop or re-start, command failed, or save failed
      */
-    bool setConfig(const char *command);
+    bool setConfig(const DFR_RadarCommandValues &values);
 
     /**
-     * @brief Commits configuration data to flash
+     * @brief Format a configuration command and send it, waiting for its response
      *
-     * @return true if command was successful
+     * @param values A command and its arguments, checked by `prepareCommand()`
+     *
+     * @return true if response was "Done"
+     */
+    bool sendConfig(const DFR_RadarCommandValues &values) const;
+
+    /**
+     * @brief Commits configuration data to flash, unless nothing has changed since the last save
+     *
+     * @return true if command was successful (or wasn't needed)
+     */
+    bool saveConfig(void);
+
+    /**
+     * @brief Record that the sensor's configuration differs from what's saved in flash
+     */
+    void markDirty(void);
+
+    /**
+     * @brief Remember a configuration command so it can be re-applied when recovering the sensor
+     *
+     * @details A command replaces the cached one for the same setting.
+     *
+     * @param values A command and its arguments
      */
-    bool saveConfig(void) const;
+    void cacheConfig(const DFR_RadarCommandValues &values);
+
+    /**
+     * @brief Check whether requests should be attempted at all
+     *
+     * @return false if the sensor is unhealthy and requests should fail fast
+     */
+    bool isResponsive(void) const;
+
+    /**
+     * @brief Update the health state with the outcome of a request
+     *
+     * @param responded true if the sensor answered (even with "Error"), false if it timed out
+     */
+    void recordResponse(bool responded) const;
+
+    /**
+     * @brief Change the health state, reporting the transition
+     */
+    void setHealth(HealthState state) const;
+
+    /**
+     * @brief Take the next step in recovering an unhealthy sensor, if it's time to
+     */
+    void recover(void);
+
+    /**
+     * @brief Add a command to the pipeline queue, sending the queue first if it is full
+     *
+     * @param values A command and its arguments, checked by `prepareCommand()`
+     *
+     * @return true if the command was queued
+     */
+    bool queueCommand(const DFR_RadarCommandValues &values);
+
+    /**
+     * @brief Write all queued commands to the sensor, keeping up to `pipelineDepth` of them
+     *        in flight, and match the responses back to their commands
+     *
+     * @details Responses are matched by position: each command's echo, then its "Done" or
+     *          "Error".  If a response is lost, the echo of a later command is used to
+     *          re-synchronize, by position too, so a second echo of the same text belongs to the
+     *          next identical command.  An echo that matches several commands in flight can't
+     *          be placed, so the rest of the batch is failed and its replies discarded.  If the
+     *          sensor goes quiet for `comTimeout`, every command in flight is failed and the
+     *          receive buffer is cleared before carrying on with the rest.
+     *
+     * @return true if every queued command succeeded
+     */
+    bool flushPipeline(void);
 
     /**
      * @brief Used to ensure commands are terminated before writing to UART
@@ -462,8 +1019,12 @@ private:
      * @note Documentation says to terminate all commands with \r\n, although
      *       it seems to work without it (sensor MCU probably catches the \0),
      *       but let's just be sure we're doing everything right.
+     *
+     * @param command   The command string to write
+     * @param exclusive true to clear the receive buffer first and wait for the write to finish;
+     *                  false when other commands may still be awaiting their responses
      */
-    size_t serialWrite(const char *command) const;
+    size_t serialWrite(const char *command, bool exclusive = true) const;
 
     /**
      * @brief Writes a command string to the sensor UART port and waits for response
@@ -493,99 +1054,121 @@ private:
     /**
      * @brief Request the value of the sensor's setting.
      *
-     * @tparam NParams        The maximum number of parameters provided in the response. (i.e. getRange has 2).
-     * @tparam MaxParamLength The maximum length a parameter can be (i.e. a float with a max value of 1500.000 has 9 including '\0').
-     * @param command         The command string to request data for.
-     * @param outParams       A 2-D array of size NParams x MaxParamLength to return the parsed parameters back.
-     * @param responsePrefix  An optional response prefix used to determine the line with relevant data.
+     * @param values A query and its arguments, checked by `prepareCommand()`
+     * @param fields Receives the fields of the response, each one terminated; must hold
+     *               `DFR_RadarCommands::longestResponse` characters
      *
-     * @return True if command was successful and the requested parameters were parsed.
+     * @return true if the query was answered with as many fields as the table says, none of
+     *         them longer than it allows
      */
-    template<size_t NParams, size_t MaxParamLength>
-    bool getConfig(
-        const char *command,
-        char outParams[NParams][MaxParamLength],
-        const char *responsePrefix
-    );
+    bool getConfig(const DFR_RadarCommandValues &values, char *fields);
 
     /**
-     * @brief Request the value of the sensor's setting. Overloaded with an empty responsePrefix.
+     * @brief Split the fields of a response line, checking them against the table
      *
-     * @tparam NParams        The maximum number of parameters provided in the response. (i.e. getRange has 2).
-     * @tparam MaxParamLength The maximum length a parameter can be (i.e. a float with a max value of 1500.000 has 9 including '\0').
-     * @param command         The command string to request data for.
-     * @param outParams       A 2-D array of size NParams x MaxParamLength to return the parsed parameters back.
+     * @param line    The response, after its prefix
+     * @param command The query it answers
+     * @param fields  Receives the fields, each one terminated
      *
-     * @return True if command was successful and the requested parameters were parsed.
+     * @return true if there were enough fields, and none was too long
      */
-    template<size_t NParams, size_t MaxParamLength>
-    bool getConfig(
-        const char *command,
-        char outParams[NParams][MaxParamLength]
-    );
+    static bool splitFields(const char *line, const DFR_RadarCommand &command, char *fields);
+
+    /**
+     * @brief Request one of the sensor's version strings
+     *
+     * @param command `getHWV` or `getSWV`
+     * @param version Receives the version string
+     *
+     * @return true if command was successful
+     */
+    bool getVersion(const DFR_RadarCommand &command, char *version);
+
+    typedef typename Traits::Transport Transport;
 
     /**
      * @brief The serial port (hardware or software) to use for communicating with the sensor
      *
      */
-    Stream *sensorUART;
+    Transport sensorUART;
+
+    static constexpr uint8_t receiveLength = Traits::receiveLength;
+    mutable char receiveBuffer[receiveLength];
+    mutable uint8_t receiveHead;
+    mutable uint8_t receiveCount;
+
+    // When the receive buffer was last filled, and when the last line read was requested and
+    // received; only kept with `Traits::timestamps`
+    struct Stamps {
+        unsigned long received;
+        DFR_RadarTiming line;
+    };
+
+    mutable DFR_RadarArray<Stamps, Traits::timestamps ? 1 : 0> stamps;
 
     // bool isConfigured;
     bool stopped;
     bool multiConfig;
     bool debugSerial;
 
+    mutable uint32_t statusSequence;
+    mutable uint32_t malformedFrames;
+
     static constexpr uint16_t readPacketTimeout = 100;
-    static constexpr size_t packetLength = 64;
+    static constexpr size_t packetLength = Traits::packetLength;
+    static constexpr size_t commandLength = DFR_RadarCommands::longestCommand;
+
+    DFR_RadarArray<DFR_RadarCommandValues, maxPipelineDepth> pipeline;
+    uint8_t pipelineDepth;
+    uint8_t pipelineCount;
+    bool pipelineFailed;
+
+    bool warmStart;
+
+    bool dirty;
+
+    // Write-back mode; only kept with `Traits::writeBack`
+    struct Deferred {
+        bool enabled;
+        unsigned long quietWindow;
+        unsigned long lastChange;
+    };
+
+    DFR_RadarArray<Deferred, Traits::writeBack ? 1 : 0> deferred;
+
+    static constexpr uint8_t configCacheSlots = Traits::configCacheSlots;
+    DFR_RadarArray<DFR_RadarCommandValues, configCacheSlots> configCache;
+
+    // Health tracking and recovery; only kept with `Traits::healthMonitor`
+    struct Monitor {
+        HealthState health;
+        uint8_t consecutiveFailures;
+        uint8_t threshold;
+        bool recovering;
+        unsigned long recoveryTimer;
+        unsigned long recoveryBackoff;
+        HealthCallback callback;
+    };
+
+    mutable DFR_RadarArray<Monitor, Traits::healthMonitor ? 1 : 0> monitor;
+
+    // Where received bytes are mirrored; only kept with `Traits::tap`
+    struct Tapping {
+        Print *output;
+        TapMode mode;
+        bool inFrame;
+    };
+
+    mutable DFR_RadarArray<Tapping, Traits::tap ? 1 : 0> tapping;
 
     static constexpr unsigned long startupDelay = 2000;
 
     static constexpr unsigned long comTimeout = 1000;
-    static constexpr const char *comResponse = "Response ";
     static constexpr const char *comStop = "sensorStop";
     static constexpr const char *comStart = "sensorStart";
     static constexpr const char *comResetSystem = "resetSystem 0";
-    static constexpr const char *comSetSensitivity = "setSensitivity %u";
-    static constexpr const char *comGetSensitivity = "getSensitivity";
-    static constexpr const char *comOutputLatency = "outputLatency -1 %u %u";
-    static constexpr const char *comSetGpioMode = "setGpioMode %u %u";
-    static constexpr const char *comGetGpioMode = "getGpioMode %u";
     static constexpr const char *comGetOutput = "getOutput 1";
-    static constexpr const char *comSetLedMode = "setLedMode 1 %u";
-    static constexpr const char *comGetLedMode = "getLedMode 1";
-    /**
-     * @brief setUartOutput command parameters:
-     *    | Parameter | Value | Description
-     * ---|-----------|-------|------------
-     *  1 | Type      |  1-2  | 1=Detection, 2=Point cloud
-     *  2 | Enabled   |  0-1  | 0=Disabled, 1=Enabled
-     *  3 | Data Mode |  0-1  | 0=Passive(getOutput only), 1=Active
-     *  4 | Period    | 1501  | Frequency of active output
-     *
-     * Serial data output mode and period, with the period unit being second:
-     *   (1) When par4 is set between 0.025 and 1500:
-     *       - The value represents the period of actively outputting data.
-     *       - When par3 = 0, data is actively outputted based on the period set by
-     *                        par4 (default parameter).
-     *       - When par3 = 1, data is outputted immediately when changes occur, or
-     *                        outputted based on the period set by par4 if there's no change.
-     *   (2) When par4 is set to >1500:
-     *       - Data is passively outputted.
-     *       - When par3 = 0, data is not actively outputted and can only be retrieved
-     *                        using the `getOutput` query command.
-     *       - When par3 = 1, data is outputted immediately when changes occur, or
-     *                        not outputted if there's no change.
-     *
-     * @link [DFRobot SEN0521 Manual](https://github.com/user-attachments/files/17264778/sen0521.pdf)
-     * @link [LeapMMW HS2xx3A v1.3 Manual](https://www.leapmmw.com/wp-content/uploads/1609/47/%E7%94%A8%E6%88%B7%E6%89%8B%E5%86%8CV1.3%EF%BC%9AHS2xx3A%E7%B3%BB%E5%88%97%E4%BA%BA%E5%AD%98%E5%9C%A8%E6%A3%80%E6%B5%8B%E6%A8%A1%E5%9D%97.pdf)
-     */
-    static constexpr const char *comSetUartOutputFull = "setUartOutput %u %u %u %.3f";
-    static constexpr const char *comSetUartOutput = "setUartOutput %u %u";
-    static constexpr const char *comGetUartOutput = "getUartOutput %u";
-    static constexpr const char *comSetEcho = "setEcho %u";
-    static constexpr const char *comGetEcho = "getEcho";
-    static constexpr const char *comGetHWV = "getHWV";
-    static constexpr const char *comGetSWV = "getSWV";
+    static constexpr const char *comGetPointCloud = "getOutput 2";
     static constexpr const char *comResponseSuccess = "Done";
     static constexpr const char *comResponseFail = "Error";
     static constexpr const char *comFailStopped = "sensor stopped already";
@@ -593,30 +1176,17 @@ private:
     static constexpr const char *comSaveCfg = "saveConfig";
     static constexpr const char *comFactoryReset = "resetCfg";
     static constexpr const char *comPrompt = "leapMMW:/>";
-
-#ifdef __AVR__
-#ifdef _STDLIB_H_
-    static constexpr const char *comSetRange = "setRange %s %s";
-    static constexpr const char *comSetLatency = "setLatency %s %s";
-    static constexpr const char *comSetInhibit = "setInhibit %s";
-#else
-#warning Floats in `sprintf()` will be converted to integers
-    static constexpr const char *comSetRange = "setRange %u %u";
-    static constexpr const char *comSetLatency = "setLatency %u %u";
-    static constexpr const char *comSetInhibit = "setInhibit %u";
-#endif
-#else
-    // TODO:
-    // #if !defined( ESP32 ) && !defined( ARDUINO_TEENSY ) && ...
-#warning Assuming floats work in `sprintf()` -- it might not!
-    //#endif
-    static constexpr const char *comSetRange = "setRange %.3f %.3f";
-    static constexpr const char *comSetLatency = "setLatency %.3f %.3f";
-    static constexpr const char *comSetInhibit = "setInhibit %.3f";
-#endif
-    static constexpr const char *comGetRange = "getRange";
-    static constexpr const char *comGetLatency = "getLatency";
-    static constexpr const char *comGetInhibit = "getInhibit";
+    // Configuration commands are described in `DFR_RadarCommands`
 };
 
+/**
+ * @brief The driver with every feature enabled; see `DFR_RadarT` to build a trimmed-down one
+ */
+typedef DFR_RadarT<> DFR_Radar;
+
+#include <DFR_RadarImpl.h>
+
+// The default build is compiled once, in DFR_Radar.cpp
+extern template class DFR_RadarT<DFR_RadarTraits>;
+
 #endif
@@ -0,0 +1,281 @@
+/**
+  * @file       DFR_RadarActivity.h
+  * @brief      Labels what's going on in the point cloud (walking, micro-motion or stationary) over a sliding window of frames
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarActivity_H_
+#define DFR_RadarActivity_H_
+
+#include <Arduino.h>
+#include <DFR_RadarPoint.h>
+
+
+/**
+ * @brief Where `DFR_RadarActivity` draws its lines; the defaults suit a room seen at about 5
+ *        frames a second
+ *
+ * @details Tune them from `DFR_RadarActivity::getStatistics()`, logged while someone walks
+ *          through, sits at a desk and leaves the room.  Frame counts are out of the window.
+ */
+struct DFR_RadarActivityThresholds {
+    DFR_RadarActivityThresholds()
+        : minMagnitude(0), motionSpeed(50), walkingSpeed(400), walkingDrift(300), motionFrames(2), walkingFrames(3) {}
+
+    /**
+     * @brief Weakest reflection counted, in tenths of a dB
+     */
+    uint16_t minMagnitude;
+
+    /**
+     * @brief Slowest radial speed that counts as motion, in millimetres per second; anything
+     *        slower is a still target (or noise)
+     */
+    uint16_t motionSpeed;
+
+    /**
+     * @brief Radial speed that counts as walking, in millimetres per second: for a point (see
+     *        `walkingFrames`), and for the frames' peak speeds on average
+     */
+    uint16_t walkingSpeed;
+
+    /**
+     * @brief How far, in millimetres, the moving target's range must change across the window
+     *        for it to be walking, whatever its speed (e.g. walking across the beam)
+     */
+    uint16_t walkingDrift;
+
+    /**
+     * @brief Frames with motion needed for micro-motion
+     */
+    uint8_t motionFrames;
+
+    /**
+     * @brief Frames with a point at walking speed needed for walking
+     */
+    uint8_t walkingFrames;
+};
+
+/**
+ * @brief Classifies each point cloud frame's activity from the velocities and magnitudes of the
+ *        last `Window` frames, for policies the presence bit alone can't drive (e.g. lights
+ *        for someone walking through, ventilation for someone sitting still)
+ *
+ *            DFR_RadarActivity<8> activity;
+ *
+ *            if( sensor.readPointCloud( points, 16, count ) && sensor.readPresence( presence ) )
+ *              if( activity.update( points, count, presence ) == DFR_RadarActivity<8>::Walking )
+ *                ...
+ *
+ * @details Each frame is boiled down to a few numbers: whether it has points, whether any of
+ *          them moves (at least `motionSpeed`), whether any moves at walking speed, its peak
+ *          speed, and the range of its strongest moving point.  The window keeps those in a
+ *          ring, with running totals, so an update costs the same however long the window is:
+ *          one pass over the frame's points, comparisons and additions only.  The decision:
+ *
+ *              Empty        no presence
+ *              Walking      walking speed in `walkingFrames` frames, peak speeds averaging
+ *                           `walkingSpeed`, or the moving target's range drifting `walkingDrift`
+ *              MicroMotion  motion in `motionFrames` frames
+ *              Stationary   anything else: presence without motion, including presence with no
+ *                           points in the window (someone sitting still may reflect none)
+ *
+ *          The averages are compared without dividing (e.g. total >= threshold x frames).
+ *          Memory is `Window` x 5 bytes (6 where words are aligned) plus a few totals; the window must be 2 to 255 frames.
+ *
+ * @tparam Window Number of frames considered
+ */
+template<uint8_t Window = 8>
+class DFR_RadarActivity {
+public:
+    /**
+     * @brief The labels, from least to most active
+     */
+    enum Activity : uint8_t {
+        Empty,
+        Stationary,
+        MicroMotion,
+        Walking
+    };
+
+    /**
+     * @brief What the decision is based on, over the frames in the window
+     */
+    struct Statistics {
+        uint8_t frames;           // Frames in the window so far (up to `Window`)
+        uint8_t occupiedFrames;   // Frames with at least one point counted
+        uint8_t movingFrames;     // Frames with a point at `motionSpeed` or faster
+        uint8_t walkingFrames;    // Frames with a point at `walkingSpeed` or faster
+        uint32_t peakSpeedSum;    // Total of each frame's peak speed, in mm/s
+        uint16_t drift;           // Range change of the strongest moving point from the oldest frame to the newest, if both have one, in mm
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * @param thresholds Where to draw the lines
+     */
+    explicit DFR_RadarActivity(const DFR_RadarActivityThresholds &thresholds = DFR_RadarActivityThresholds())
+        : thresholds(thresholds) {
+        static_assert(Window >= 2, "The window needs at least 2 frames");
+        reset();
+    }
+
+    /**
+     * @brief Change the thresholds; they apply from the next update (the window isn't recounted,
+     *        so best done before starting or after `reset()`)
+     */
+    void setThresholds(const DFR_RadarActivityThresholds &thresholds) { this->thresholds = thresholds; }
+
+    /**
+     * @brief Get the thresholds in use
+     */
+    const DFR_RadarActivityThresholds &getThresholds(void) const { return thresholds; }
+
+    /**
+     * @brief Add a frame and classify the window
+     *
+     * @param points   The frame's points, e.g. from `readPointCloud()` or `cloud.getPoints()`
+     * @param count    How many
+     * @param presence The sensor's presence bit, if it was read; leave it out to go by the points alone
+     *
+     * @return the activity now
+     */
+    Activity update(const DFR_RadarPoint points[], const uint8_t count, const bool presence = true) {
+        Frame frame = { 0, 0, 0 };
+        uint16_t strongest = 0;
+
+        for (uint8_t i = 0; i < count; i++) {
+            const DFR_RadarPoint &point = points[i];
+            if (point.magnitude < thresholds.minMagnitude)
+                continue;
+
+            frame.flags |= Occupied;
+
+            // In 16 bits, even for -32768
+            const uint16_t speed = point.velocity < 0 ? static_cast<uint16_t>(0 - static_cast<uint16_t>(point.velocity)) : point.velocity;
+            if (speed > frame.peakSpeed)
+                frame.peakSpeed = speed;
+
+            if (speed < thresholds.motionSpeed)
+                continue;
+
+            frame.flags |= Moving;
+            if (speed >= thresholds.walkingSpeed)
+                frame.flags |= Fast;
+
+            // The strongest moving point stands for the target; 0 means there's none
+            if (point.magnitude >= strongest) {
+                strongest = point.magnitude;
+                frame.range = point.range ? point.range : 1;
+            }
+        }
+
+        // The oldest frame leaves the window as this one comes in
+        if (statistics.frames == Window)
+            remove(frames[next]);
+        else
+            statistics.frames++;
+
+        frames[next] = frame;
+        add(frame);
+
+        if (++next == Window)
+            next = 0;
+
+        // Against the oldest frame still in the window, if both have a moving point
+        const uint16_t oldest = frames[statistics.frames == Window ? next : 0].range;
+        if (frame.range && oldest)
+            statistics.drift = frame.range > oldest ? frame.range - oldest : oldest - frame.range;
+        else
+            statistics.drift = 0;
+
+        activity = classify(statistics, presence);
+        return activity;
+    }
+
+    /**
+     * @brief The decision, on statistics from `getStatistics()` or your own; see the class
+     *        description for the rules
+     *
+     * @param window   The statistics
+     * @param presence Whether the sensor detects presence
+     */
+    Activity classify(const Statistics &window, const bool presence = true) const {
+        if (!presence)
+            return Empty;
+
+        if (window.walkingFrames >= thresholds.walkingFrames ||
+            window.peakSpeedSum >= static_cast<uint32_t>(thresholds.walkingSpeed) * window.frames ||
+            window.drift >= thresholds.walkingDrift)
+            return Walking;
+
+        if (window.movingFrames >= thresholds.motionFrames)
+            return MicroMotion;
+
+        return Stationary;
+    }
+
+    /**
+     * @brief Get the activity as of the last update
+     */
+    Activity getActivity(void) const { return activity; }
+
+    /**
+     * @brief Get the statistics the last decision was based on, e.g. to tune the thresholds
+     */
+    const Statistics &getStatistics(void) const { return statistics; }
+
+    /**
+     * @brief Empty the window
+     */
+    void reset(void) {
+        statistics.frames = 0;
+        statistics.occupiedFrames = 0;
+        statistics.movingFrames = 0;
+        statistics.walkingFrames = 0;
+        statistics.peakSpeedSum = 0;
+        statistics.drift = 0;
+        next = 0;
+        activity = Empty;
+    }
+
+private:
+    enum Flag : uint8_t {
+        Occupied = 1,
+        Moving = 2,
+        Fast = 4
+    };
+
+    struct Frame {
+        uint8_t flags;
+        uint16_t peakSpeed;
+        uint16_t range;
+    };
+
+    void add(const Frame &frame) {
+        statistics.occupiedFrames += (frame.flags & Occupied) != 0;
+        statistics.movingFrames += (frame.flags & Moving) != 0;
+        statistics.walkingFrames += (frame.flags & Fast) != 0;
+        statistics.peakSpeedSum += frame.peakSpeed;
+    }
+
+    void remove(const Frame &frame) {
+        statistics.occupiedFrames -= (frame.flags & Occupied) != 0;
+        statistics.movingFrames -= (frame.flags & Moving) != 0;
+        statistics.walkingFrames -= (frame.flags & Fast) != 0;
+        statistics.peakSpeedSum -= frame.peakSpeed;
+    }
+
+    DFR_RadarActivityThresholds thresholds;
+
+    Frame frames[Window];
+    uint8_t next;
+
+    Statistics statistics;
+    Activity activity;
+};
+
+#endif
@@ -0,0 +1,484 @@
+/**
+  * @file       DFR_RadarCalibration.h
+  * @brief      Sweeps sensitivity, detection range and trigger latency against a known target, and keeps the best profile
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarCalibration_H_
+#define DFR_RadarCalibration_H_
+
+#include <Arduino.h>
+
+
+/**
+ * @brief Finds the sensitivity, detection range and trigger latency that work best for an
+ *        installation, by trying every combination in a grid and grading the sensor against
+ *        a reference target the sketch switches on and off (e.g. a fan or a motorised
+ *        reflector on a relay)
+ *
+ *            const uint8_t levels[] = { 3, 5, 7, 9 };
+ *            const Calibration::Range ranges[] = { { 0, 3 }, { 0, 4.5 } };
+ *            const Calibration::Latency latencies[] = { { 0.025, 1 }, { 0.5, 2 } };
+ *
+ *            Calibration calibration( sensor, switchTarget, levels, 4, ranges, 2, latencies, 2 );
+ *            calibration.begin();
+ *
+ *            void loop() {
+ *              if( calibration.run() == Calibration::Finished )
+ *                ...   // The best profile is in flash now
+ *            }
+ *
+ * @details Each step measures one combination in two phases: with the target off, so the room
+ *          is as empty as it gets (every detection is a false trigger), then with it on (every
+ *          reading without presence is a missed trigger).  Each phase starts after the sensor
+ *          has had time to react, i.e. the settle time plus its disappearance or confirmation
+ *          delay, and grades a fixed number of readings, so steps are scored alike: false
+ *          triggers and missed triggers, weighted.  A step is cut short once its score can't
+ *          beat the best so far.  On a tie, the shorter confirmation delay wins.
+ *
+ *          Combinations are visited in reflected order (sensitivity changing fastest, latency
+ *          slowest, each running back and forth), so every step after the first changes a
+ *          single setting: one command in one stop/start.  Nothing is saved to flash during
+ *          the sweep; the sensor is put in write-back mode, and only the winning profile is
+ *          committed at the end, with one more flash write.  Its own write-back mode and quiet
+ *          window are restored afterwards.
+ *
+ * @note If the sweep fails, the sensor is rebooted so it runs the profile in flash again,
+ *       rather than an untested combination; restoring write-back mode may then save that
+ *       same profile once more.
+ *
+ * @tparam Radar The sensor's driver (e.g. `DFR_Radar`)
+ */
+template<typename Radar>
+class DFR_RadarCalibration {
+public:
+    /**
+     * @brief A detection range to try, in metres
+     */
+    struct Range {
+        float start;
+        float end;
+    };
+
+    /**
+     * @brief A trigger latency to try, in seconds
+     */
+    struct Latency {
+        float confirmation;
+        float disappearance;
+    };
+
+    /**
+     * @brief Switches the reference target on (true) or off (false)
+     */
+    typedef void (*Reference)(bool present);
+
+    /**
+     * @brief How one combination did
+     */
+    struct Result {
+        uint8_t sensitivity;
+        Range range;
+        Latency latency;
+
+        uint16_t falseTriggers;     // Readings with presence while the target was off
+        uint16_t missedTriggers;    // Readings without presence while it was on
+        uint32_t score;             // Weighted total of the two; lower is better
+
+        bool complete;              // false if cut short (it couldn't win) or the sensor stopped answering
+    };
+
+    /**
+     * @brief What a call to `run()` did
+     */
+    enum Progress : uint8_t {
+        Measuring,  // The current step isn't done yet (or the sweep isn't running)
+        Stepped,    // A step is done; its result is in `getLast()`
+        Finished,   // The sweep is done and the best profile was committed (see `getBest()`)
+        Failed      // The sweep stopped: the sensor couldn't be reconfigured, no step completed, or the commit failed
+    };
+
+    /**
+     * @brief Constructor; the grid isn't copied, so it must outlive the sweep
+     *
+     * @param radar            The sensor to calibrate
+     * @param reference        Switches the reference target
+     * @param sensitivities    Sensitivity levels to try (0-9)
+     * @param sensitivityCount How many
+     * @param ranges           Detection ranges to try
+     * @param rangeCount       How many
+     * @param latencies        Trigger latencies to try
+     * @param latencyCount     How many
+     */
+    DFR_RadarCalibration(Radar &radar, const Reference reference,
+                         const uint8_t sensitivities[], const uint8_t sensitivityCount,
+                         const Range ranges[], const uint8_t rangeCount,
+                         const Latency latencies[], const uint8_t latencyCount)
+        : radar(radar), reference(reference), sensitivities(sensitivities), ranges(ranges), latencies(latencies),
+          samples(40), sampleInterval(250), settleTime(2000), falseWeight(1), missedWeight(1),
+          phase(Stopped), phaseStart(0), guard(0), lastSample(0), graded(0), failures(0),
+          hasBest(false), steps(0), commands(0), reconfigurationTime(0),
+          savedWriteBack(false), savedQuietWindow(0) {
+        counts[Sensitivity] = sensitivityCount;
+        counts[DetectionRange] = rangeCount;
+        counts[TriggerLatency] = latencyCount;
+    }
+
+    /**
+     * @brief Set how many readings are graded in each phase of a step, and how often
+     *
+     * @param samples        Readings per phase
+     * @param sampleInterval Time in milliseconds between readings
+     */
+    void setWindow(const uint16_t samples, const unsigned long sampleInterval = 250) {
+        this->samples = samples;
+        this->sampleInterval = sampleInterval;
+    }
+
+    /**
+     * @brief Set how long the sensor is given after a restart before its trigger latency counts
+     *
+     * @param settleTime Time in milliseconds
+     */
+    void setSettleTime(const unsigned long settleTime) { this->settleTime = settleTime; }
+
+    /**
+     * @brief Set how much a false trigger and a missed trigger each add to a step's score
+     */
+    void setWeights(const uint8_t falseWeight, const uint8_t missedWeight) {
+        this->falseWeight = falseWeight;
+        this->missedWeight = missedWeight;
+    }
+
+    /**
+     * @brief Put the sensor in write-back mode, apply the first combination and start measuring
+     *
+     * @return false if the grid is empty, there's no reference, or the sensor couldn't be configured
+     */
+    bool begin(void) {
+        if (!counts[Sensitivity] || !counts[DetectionRange] || !counts[TriggerLatency] || reference == nullptr || !samples)
+            return false;
+
+        // The longest quiet window there is, so `update()` never saves partway through
+        savedWriteBack = radar.isWriteBack();
+        savedQuietWindow = radar.getQuietWindow();
+
+        if (!radar.setWriteBack(true, static_cast<unsigned long>(-1)))
+            return false;
+
+        for (uint8_t i = 0; i < dimensions; i++) {
+            index[i] = 0;
+            forward[i] = true;
+        }
+
+        hasBest = false;
+        steps = 0;
+        commands = 0;
+        reconfigurationTime = 0;
+
+        reference(false);
+
+        const unsigned long started = millis();
+        bool applied = radar.configBegin();
+        if (applied) {
+            applied = apply(Sensitivity) && apply(DetectionRange) && apply(TriggerLatency);
+            applied = radar.configEnd() && applied;
+        }
+        reconfigurationTime += millis() - started;
+
+        if (!applied) {
+            abandon();
+            return false;
+        }
+
+        startStep();
+        return true;
+    }
+
+    /**
+     * @brief Take a reading if one is due, and move on to the next phase or step when this one
+     *        is done; call it from `loop()`
+     *
+     * @details Reconfiguring the sensor between steps takes one command cycle, during which
+     *          this doesn't return.
+     *
+     * @return what was done
+     */
+    Progress run(void) {
+        radar.update();
+
+        if (phase == Stopped)
+            return Measuring;
+
+        if (phase == Committing)
+            return finish();
+
+        const unsigned long now = millis();
+
+        if (now - phaseStart < guard || ((graded || failures) && now - lastSample < sampleInterval))
+            return Measuring;
+
+        bool presence;
+        const bool read = radar.readPresence(presence);
+        lastSample = millis();
+
+        // Give up on a step the sensor keeps failing to answer
+        if (!read)
+            return ++failures > samples ? endStep(false) : Measuring;
+
+        graded++;
+
+        if (phase == Baseline && presence)
+            current.falseTriggers++;
+        else if (phase == Present && !presence)
+            current.missedTriggers++;
+
+        current.score = static_cast<uint32_t>(current.falseTriggers) * falseWeight + static_cast<uint32_t>(current.missedTriggers) * missedWeight;
+
+        // No point finishing a step that has already lost
+        if (hasBest && current.score > best.score)
+            return endStep(false);
+
+        if (graded < samples)
+            return Measuring;
+
+        if (phase == Present)
+            return endStep(true);
+
+        // The room has been graded empty; now with the target
+        phase = Present;
+        reference(true);
+        phaseStart = lastSample;
+        guard = milliseconds(latencies[index[TriggerLatency]].confirmation);
+        graded = 0;
+        return Measuring;
+    }
+
+    /**
+     * @brief Check if a sweep is in progress
+     */
+    bool isRunning(void) const { return phase != Stopped; }
+
+    /**
+     * @brief Get the result of the last step
+     */
+    const Result &getLast(void) const { return last; }
+
+    /**
+     * @brief Get the best result so far, if `hasResult()`
+     */
+    const Result &getBest(void) const { return best; }
+
+    /**
+     * @brief Check if any step has completed, i.e. if `getBest()` holds a result
+     */
+    bool hasResult(void) const { return hasBest; }
+
+    /**
+     * @brief Get the number of steps done so far
+     */
+    uint16_t getStep(void) const { return steps; }
+
+    /**
+     * @brief Get the number of steps in the sweep (one per combination)
+     */
+    uint16_t getStepCount(void) const {
+        return static_cast<uint16_t>(counts[Sensitivity]) * counts[DetectionRange] * counts[TriggerLatency];
+    }
+
+    /**
+     * @brief Get the number of configuration commands sent so far, the final commit included
+     */
+    uint32_t getCommandCount(void) const { return commands; }
+
+    /**
+     * @brief Get the time spent reconfiguring the sensor so far
+     *
+     * @return time in milliseconds
+     */
+    unsigned long getReconfigurationTime(void) const { return reconfigurationTime; }
+
+private:
+    enum Dimension : uint8_t {
+        Sensitivity,
+        DetectionRange,
+        TriggerLatency,
+        dimensions
+    };
+
+    enum Phase : uint8_t {
+        Stopped,
+        Baseline,
+        Present,
+        Committing
+    };
+
+    static unsigned long milliseconds(const float seconds) { return static_cast<unsigned long>(seconds * 1000); }
+
+    bool apply(const Dimension dimension) {
+        commands++;
+
+        switch (dimension) {
+            case Sensitivity:
+                return radar.setSensitivity(sensitivities[index[Sensitivity]]);
+            case DetectionRange:
+                return radar.setDetectionRange(ranges[index[DetectionRange]].start, ranges[index[DetectionRange]].end);
+            default:
+                return radar.setTriggerLatency(latencies[index[TriggerLatency]].confirmation, latencies[index[TriggerLatency]].disappearance);
+        }
+    }
+
+    void startStep(void) {
+        current.sensitivity = sensitivities[index[Sensitivity]];
+        current.range = ranges[index[DetectionRange]];
+        current.latency = latencies[index[TriggerLatency]];
+        current.falseTriggers = 0;
+        current.missedTriggers = 0;
+        current.score = 0;
+        current.complete = false;
+
+        // The sensor has just restarted, and the target may have just been switched off
+        reference(false);
+        phase = Baseline;
+        phaseStart = millis();
+        guard = settleTime + milliseconds(current.latency.disappearance);
+        graded = 0;
+        failures = 0;
+    }
+
+    Progress endStep(const bool complete) {
+        current.complete = complete;
+        last = current;
+        steps++;
+
+        if (complete && (!hasBest || current.score < best.score ||
+                         (current.score == best.score && current.latency.confirmation < best.latency.confirmation))) {
+            best = last;
+            for (uint8_t i = 0; i < dimensions; i++)
+                bestIndex[i] = index[i];
+            hasBest = true;
+        }
+
+        // The next combination differs from this one in a single setting
+        Dimension changed = dimensions;
+        for (uint8_t i = 0; i < dimensions && changed == dimensions; i++) {
+            const int16_t next = index[i] + (forward[i] ? 1 : -1);
+
+            if (next >= 0 && next < counts[i]) {
+                index[i] = next;
+                changed = static_cast<Dimension>(i);
+            } else {
+                forward[i] = !forward[i];
+            }
+        }
+
+        if (changed == dimensions) {
+            phase = Committing;
+            return Stepped;
+        }
+
+        const unsigned long started = millis();
+        const bool applied = apply(changed);
+        reconfigurationTime += millis() - started;
+
+        if (!applied) {
+            abandon();
+            return Failed;
+        }
+
+        startStep();
+        return Stepped;
+    }
+
+    Progress finish(void) {
+        if (!hasBest) {
+            abandon();
+            return Failed;
+        }
+
+        // Only the settings that differ from the last step's need sending
+        Dimension differing[dimensions];
+        uint8_t differences = 0;
+        for (uint8_t i = 0; i < dimensions; i++) {
+            if (index[i] != bestIndex[i]) {
+                index[i] = bestIndex[i];
+                differing[differences++] = static_cast<Dimension>(i);
+            }
+        }
+
+        const unsigned long started = millis();
+
+        bool applied = differences < 2 || radar.configBegin();
+        for (uint8_t i = 0; i < differences && applied; i++)
+            applied = apply(differing[i]);
+
+        if (differences >= 2)
+            applied = radar.configEnd() && applied;
+
+        commands++;
+        applied = applied && radar.commit();
+        reconfigurationTime += millis() - started;
+
+        if (!applied) {
+            abandon();
+            return Failed;
+        }
+
+        reference(false);
+        phase = Stopped;
+        radar.setWriteBack(savedWriteBack, savedQuietWindow);
+        return Finished;
+    }
+
+    // Stops the sweep and puts the sensor back as it was: running the profile in flash, in the
+    // write-back mode it was in
+    void abandon(void) {
+        reference(false);
+        phase = Stopped;
+
+        radar.reboot();
+        radar.setWriteBack(savedWriteBack, savedQuietWindow);
+    }
+
+    Radar &radar;
+    const Reference reference;
+
+    const uint8_t *sensitivities;
+    const Range *ranges;
+    const Latency *latencies;
+    uint8_t counts[dimensions];
+
+    uint16_t samples;
+    unsigned long sampleInterval;
+    unsigned long settleTime;
+    uint8_t falseWeight;
+    uint8_t missedWeight;
+
+    uint8_t index[dimensions];
+    bool forward[dimensions];
+    uint8_t bestIndex[dimensions];
+
+    Phase phase;
+    unsigned long phaseStart;
+    unsigned long guard;
+    unsigned long lastSample;
+    uint16_t graded;
+    uint16_t failures;
+
+    Result current;
+    Result last;
+    Result best;
+    bool hasBest;
+
+    uint16_t steps;
+    uint32_t commands;
+    unsigned long reconfigurationTime;
+
+    // The sensor's own write-back mode, to restore once the sweep is over
+    bool savedWriteBack;
+    unsigned long savedQuietWindow;
+};
+
+#endif
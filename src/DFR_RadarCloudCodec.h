@@ -0,0 +1,506 @@
+/**
+  * @file       DFR_RadarCloudCodec.h
+  * @brief      Compresses point cloud frames for constrained links (LoRa, BLE): quantised, delta coded against the previous frame and bit-packed
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarCloudCodec_H_
+#define DFR_RadarCloudCodec_H_
+
+#include <Arduino.h>
+#include <DFR_RadarPoint.h>
+
+
+/**
+ * @brief The layout of an encoded frame, shared by the encoder, the decoder and the tools in
+ *        `extras/linux/`
+ *
+ * @details A frame is a header, then a bit stream (most significant bit first, padded with
+ *          zeros to a whole byte):
+ *
+ *              header:  flags (keyframe << 7 | sequence)  [range step  velocity step  magnitude step]
+ *              bits:    count  { range  magnitude  velocity } x count
+ *
+ *          The sequence number counts frames modulo 128.  Only keyframes carry the steps the
+ *          points were quantised with (in mm, mm/s and 0.1 dB); delta frames use those of the
+ *          last keyframe.  Points are sent in order of range, each field as the difference
+ *          from a prediction: the same point of the previous frame in a delta frame, while
+ *          it has one, and otherwise the previous point of this frame (or 0).  Differences
+ *          are zigzag coded (0, -1, 1, -2, ... as 0, 1, 2, 3, ...) and written as Exp-Golomb
+ *          codes of the orders below; the count is an order 0 Exp-Golomb code.
+ *
+ *          There's no checksum: LoRa and BLE check their packets already.
+ */
+struct DFR_RadarCloudFormat {
+    static constexpr uint8_t keyframe = 0x80;
+    static constexpr uint8_t sequenceMask = 0x7F;
+
+    static constexpr size_t headerLength = 1;
+    static constexpr size_t keyframeHeaderLength = 4;
+
+    static constexpr uint8_t rangeOrder = 2;
+    static constexpr uint8_t magnitudeOrder = 1;
+    static constexpr uint8_t velocityOrder = 1;
+
+    /**
+     * @brief Most bytes a frame of `count` points can take, whatever the points
+     *
+     * @details The count takes up to 17 bits and a point up to 33 + 34 + 34.
+     */
+    static constexpr size_t maxFrameLength(const uint8_t count) {
+        return keyframeHeaderLength + (17 + 101 * static_cast<size_t>(count) + 7) / 8;
+    }
+
+    /**
+     * @brief A point in steps, as coded
+     */
+    struct Quantised {
+        uint16_t range;
+        int16_t velocity;
+        uint16_t magnitude;
+    };
+
+    static uint32_t zigzag(const int32_t value) {
+        return value < 0 ? (static_cast<uint32_t>(-(value + 1)) << 1) | 1 : static_cast<uint32_t>(value) << 1;
+    }
+
+    static int32_t unzigzag(const uint32_t value) {
+        return value & 1 ? -static_cast<int32_t>(value >> 1) - 1 : static_cast<int32_t>(value >> 1);
+    }
+
+    /**
+     * @brief Bit-packs Exp-Golomb codes into a buffer, most significant bit first
+     */
+    class BitWriter {
+    public:
+        BitWriter(uint8_t *buffer, const size_t size) : buffer(buffer), size(size), bytes(0), bits(0), full(false) {}
+
+        void writeCode(const uint32_t value, const uint8_t order) {
+            // value + 2^order in binary, after a zero for each of its bits past the first `order + 1`
+            const uint32_t code = value + (static_cast<uint32_t>(1) << order);
+            uint8_t width = 0;
+            for (uint32_t rest = code; rest; rest >>= 1)
+                width++;
+
+            for (uint8_t i = order + 1; i < width; i++)
+                writeBit(false);
+
+            // One bit at a time, so AVR doesn't shift by a variable amount for each
+            for (uint32_t mask = static_cast<uint32_t>(1) << (width - 1); mask; mask >>= 1)
+                writeBit(code & mask);
+        }
+
+        /**
+         * @return the number of bytes written, the last one padded with zeros
+         */
+        size_t length(void) const { return bytes + (bits ? 1 : 0); }
+
+        /**
+         * @return true if the codes didn't all fit
+         */
+        bool overflowed(void) const { return full; }
+
+    private:
+        void writeBit(const bool bit) {
+            if (bytes == size) {
+                full = true;
+                return;
+            }
+
+            if (!bits)
+                buffer[bytes] = 0;
+            if (bit)
+                buffer[bytes] |= 0x80 >> bits;
+
+            if (++bits == 8) {
+                bits = 0;
+                bytes++;
+            }
+        }
+
+        uint8_t *buffer;
+        size_t size;
+        size_t bytes;
+        uint8_t bits;
+        bool full;
+    };
+
+    /**
+     * @brief Reads back what a `BitWriter` wrote
+     */
+    class BitReader {
+    public:
+        BitReader(const uint8_t *buffer, const size_t size) : buffer(buffer), size(size), bytes(0), bits(0), failed(false) {}
+
+        /**
+         * @return the value, or 0 if the code runs past the end or is too long (see `hasFailed()`)
+         */
+        uint32_t readCode(const uint8_t order) {
+            uint8_t zeros = 0;
+            while (!readBit()) {
+                if (failed || ++zeros > 32 - order - 1) {
+                    failed = true;
+                    return 0;
+                }
+            }
+
+            uint32_t code = 1;
+            for (uint8_t i = 0; i < zeros + order; i++)
+                code = code << 1 | readBit();
+
+            return failed ? 0 : code - (static_cast<uint32_t>(1) << order);
+        }
+
+        /**
+         * @return true if a code ran past the end of the buffer or was malformed
+         */
+        bool hasFailed(void) const { return failed; }
+
+    private:
+        uint8_t readBit(void) {
+            if (bytes == size) {
+                failed = true;
+                return 1;
+            }
+
+            const uint8_t bit = buffer[bytes] >> (7 - bits) & 1;
+            if (++bits == 8) {
+                bits = 0;
+                bytes++;
+            }
+
+            return bit;
+        }
+
+        const uint8_t *buffer;
+        size_t size;
+        size_t bytes;
+        uint8_t bits;
+        bool failed;
+    };
+};
+
+/**
+ * @brief Encodes point cloud frames one after the other, for a `DFR_RadarCloudDecoder` at the
+ *        other end of the link
+ *
+ *            DFR_RadarCloudEncoder<16> encoder( 10, 10, 5 );   // 1 cm, 1 cm/s, 0.5 dB
+ *
+ *            if( cloud.decode( line, length ) ) {
+ *              uint8_t frame[64];
+ *              const size_t length = encoder.encode( cloud.getPoints(), cloud.getCount(), frame, sizeof( frame ) );
+ *              if( length )
+ *                radio.send( frame, length );
+ *            }
+ *
+ * @details Frames are sent relative to the previous one, except every `keyframeInterval`th
+ *          frame, which is decoded on its own and lets a decoder that missed a frame catch up.
+ *          Call `requestKeyframe()` when the link knows a frame was lost (e.g. a BLE
+ *          reconnection) to catch up sooner.  Coarser steps compress better, and small
+ *          movements between frames turn into short codes.  No floating point, and no
+ *          allocation: the previous frame is kept in `MaxPoints` x 6 bytes.
+ *
+ * @tparam MaxPoints Most points encoded per frame; the rest of a larger frame is dropped
+ */
+template<uint8_t MaxPoints = 16>
+class DFR_RadarCloudEncoder {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param rangeStep        Range quantum in millimetres (1-255)
+     * @param velocityStep     Velocity quantum in millimetres per second (1-255)
+     * @param magnitudeStep    Magnitude quantum in tenths of a dB (1-255)
+     * @param keyframeInterval Send a keyframe at least once in this many frames (1 for only keyframes)
+     */
+    explicit DFR_RadarCloudEncoder(const uint8_t rangeStep = 10, const uint8_t velocityStep = 10, const uint8_t magnitudeStep = 5,
+                                   const uint8_t keyframeInterval = 16)
+        : rangeStep(rangeStep ? rangeStep : 1), velocityStep(velocityStep ? velocityStep : 1),
+          magnitudeStep(magnitudeStep ? magnitudeStep : 1), keyframeInterval(keyframeInterval ? keyframeInterval : 1),
+          previousCount(0), sinceKeyframe(0), sequence(0), keyframeDue(true), frames(0), keyframes(0), bytes(0) {}
+
+    /**
+     * @brief Encode a frame
+     *
+     * @param points A frame's points, e.g. `cloud.getPoints()`
+     * @param count  How many
+     * @param frame  Where to put the encoded frame; `DFR_RadarCloudFormat::maxFrameLength()` always fits
+     * @param size   Its size
+     *
+     * @return the encoded frame's length, or 0 if it didn't fit (nothing changes, so the next
+     *         frame is encoded as if this one had never been)
+     */
+    size_t encode(const DFR_RadarPoint points[], uint8_t count, uint8_t *frame, const size_t size) {
+        if (count > MaxPoints)
+            count = MaxPoints;
+
+        const bool key = keyframeDue || sinceKeyframe + 1 >= keyframeInterval;
+        const size_t header = key ? DFR_RadarCloudFormat::keyframeHeaderLength : DFR_RadarCloudFormat::headerLength;
+        if (size < header)
+            return 0;
+
+        frame[0] = (key ? DFR_RadarCloudFormat::keyframe : 0) | (sequence & DFR_RadarCloudFormat::sequenceMask);
+        if (key) {
+            frame[1] = rangeStep;
+            frame[2] = velocityStep;
+            frame[3] = magnitudeStep;
+        }
+
+        // Quantise and sort by range, so consecutive frames line up point by point
+        DFR_RadarCloudFormat::Quantised current[MaxPoints];
+        for (uint8_t i = 0; i < count; i++) {
+            DFR_RadarCloudFormat::Quantised point;
+            point.range = (points[i].range + rangeStep / 2) / rangeStep;
+            point.magnitude = (points[i].magnitude + magnitudeStep / 2) / magnitudeStep;
+            point.velocity = points[i].velocity >= 0 ? (points[i].velocity + velocityStep / 2) / velocityStep
+                                                     : -((-points[i].velocity + velocityStep / 2) / velocityStep);
+
+            uint8_t j = i;
+            for (; j > 0 && current[j - 1].range > point.range; j--)
+                current[j] = current[j - 1];
+            current[j] = point;
+        }
+
+        DFR_RadarCloudFormat::BitWriter writer(frame + header, size - header);
+        writer.writeCode(count, 0);
+
+        for (uint8_t i = 0; i < count; i++) {
+            const DFR_RadarCloudFormat::Quantised &prediction = predict(current, i, key);
+            writer.writeCode(DFR_RadarCloudFormat::zigzag(static_cast<int32_t>(current[i].range) - prediction.range), DFR_RadarCloudFormat::rangeOrder);
+            writer.writeCode(DFR_RadarCloudFormat::zigzag(static_cast<int32_t>(current[i].magnitude) - prediction.magnitude), DFR_RadarCloudFormat::magnitudeOrder);
+            writer.writeCode(DFR_RadarCloudFormat::zigzag(static_cast<int32_t>(current[i].velocity) - prediction.velocity), DFR_RadarCloudFormat::velocityOrder);
+        }
+
+        if (writer.overflowed())
+            return 0;
+
+        for (uint8_t i = 0; i < count; i++)
+            previous[i] = current[i];
+        previousCount = count;
+
+        sinceKeyframe = key ? 0 : sinceKeyframe + 1;
+        keyframeDue = false;
+        sequence++;
+
+        const size_t length = header + writer.length();
+        frames++;
+        keyframes += key;
+        bytes += length;
+        return length;
+    }
+
+    /**
+     * @brief Make the next frame a keyframe
+     */
+    void requestKeyframe(void) { keyframeDue = true; }
+
+    /**
+     * @brief Get the number of frames encoded
+     */
+    uint32_t getFrameCount(void) const { return frames; }
+
+    /**
+     * @brief Get the number of those that were keyframes
+     */
+    uint32_t getKeyframeCount(void) const { return keyframes; }
+
+    /**
+     * @brief Get the total length of the frames encoded, in bytes
+     */
+    uint32_t getByteCount(void) const { return bytes; }
+
+private:
+    const DFR_RadarCloudFormat::Quantised &predict(const DFR_RadarCloudFormat::Quantised current[], const uint8_t i, const bool key) const {
+        static const DFR_RadarCloudFormat::Quantised zero = { 0, 0, 0 };
+
+        if (!key && i < previousCount)
+            return previous[i];
+
+        return i ? current[i - 1] : zero;
+    }
+
+    const uint8_t rangeStep;
+    const uint8_t velocityStep;
+    const uint8_t magnitudeStep;
+    const uint8_t keyframeInterval;
+
+    DFR_RadarCloudFormat::Quantised previous[MaxPoints];
+    uint8_t previousCount;
+
+    uint8_t sinceKeyframe;
+    uint8_t sequence;
+    bool keyframeDue;
+
+    uint32_t frames;
+    uint32_t keyframes;
+    uint32_t bytes;
+};
+
+/**
+ * @brief Decodes the frames of a `DFR_RadarCloudEncoder`, e.g. on a gateway; it builds on
+ *        Linux too (see `extras/linux/cloud-codec.cpp`)
+ *
+ *            DFR_RadarCloudDecoder<16> decoder;
+ *            DFR_RadarPoint points[16];
+ *            uint8_t count;
+ *
+ *            if( decoder.decode( packet, length, points, 16, count ) )
+ *              heatmap.update( points, count );
+ *
+ * @details Frames must be passed in the order they were sent.  After a gap in the sequence (or
+ *          before the first keyframe), delta frames are skipped until the next keyframe.
+ *          Points come out in order of range, rounded to the encoder's steps.
+ *
+ * @tparam MaxPoints Most points per frame; at least the encoder's
+ */
+template<uint8_t MaxPoints = 16>
+class DFR_RadarCloudDecoder {
+public:
+    DFR_RadarCloudDecoder()
+        : rangeStep(0), velocityStep(0), magnitudeStep(0), previousCount(0), expected(0), synchronised(false),
+          frames(0), skipped(0), missing(0), malformed(0) {}
+
+    /**
+     * @brief Decode a frame
+     *
+     * @param frame  The encoded frame
+     * @param length Its length
+     * @param points Where to put its points
+     * @param size   Most points to put there; the nearest are kept if the frame has more
+     * @param count  The number of points put there
+     *
+     * @return false if the frame is malformed, or is a delta frame that can't be decoded until the next keyframe
+     */
+    bool decode(const uint8_t *frame, const size_t length, DFR_RadarPoint points[], const uint8_t size, uint8_t &count) {
+        if (length < DFR_RadarCloudFormat::headerLength) {
+            malformed++;
+            return false;
+        }
+
+        const bool key = frame[0] & DFR_RadarCloudFormat::keyframe;
+        const uint8_t sequence = frame[0] & DFR_RadarCloudFormat::sequenceMask;
+
+        if (synchronised && sequence != expected) {
+            missing += (sequence - expected) & DFR_RadarCloudFormat::sequenceMask;
+            synchronised = false;
+        }
+
+        expected = (sequence + 1) & DFR_RadarCloudFormat::sequenceMask;
+
+        size_t header = DFR_RadarCloudFormat::headerLength;
+        if (key) {
+            header = DFR_RadarCloudFormat::keyframeHeaderLength;
+            if (length < header || !frame[1] || !frame[2] || !frame[3]) {
+                synchronised = false;
+                malformed++;
+                return false;
+            }
+        } else if (!synchronised) {
+            skipped++;
+            return false;
+        }
+
+        DFR_RadarCloudFormat::BitReader reader(frame + header, length - header);
+        const uint32_t total = reader.readCode(0);
+
+        if (reader.hasFailed() || total > MaxPoints) {
+            synchronised = false;
+            malformed++;
+            return false;
+        }
+
+        // Decoded aside, so a frame that turns out to be malformed leaves the reference alone
+        DFR_RadarCloudFormat::Quantised current[MaxPoints];
+        for (uint8_t i = 0; i < total; i++) {
+            static const DFR_RadarCloudFormat::Quantised zero = { 0, 0, 0 };
+            const DFR_RadarCloudFormat::Quantised &prediction = !key && i < previousCount ? previous[i] : i ? current[i - 1] : zero;
+
+            const int32_t range = prediction.range + DFR_RadarCloudFormat::unzigzag(reader.readCode(DFR_RadarCloudFormat::rangeOrder));
+            const int32_t magnitude = prediction.magnitude + DFR_RadarCloudFormat::unzigzag(reader.readCode(DFR_RadarCloudFormat::magnitudeOrder));
+            const int32_t velocity = prediction.velocity + DFR_RadarCloudFormat::unzigzag(reader.readCode(DFR_RadarCloudFormat::velocityOrder));
+
+            if (reader.hasFailed() || range < 0 || range > 65535 || magnitude < 0 || magnitude > 65535 ||
+                velocity < -32768 || velocity > 32767) {
+                synchronised = false;
+                malformed++;
+                return false;
+            }
+
+            current[i].range = range;
+            current[i].magnitude = magnitude;
+            current[i].velocity = velocity;
+        }
+
+        if (key) {
+            rangeStep = frame[1];
+            velocityStep = frame[2];
+            magnitudeStep = frame[3];
+        }
+
+        for (uint8_t i = 0; i < total; i++)
+            previous[i] = current[i];
+        previousCount = total;
+        synchronised = true;
+        frames++;
+
+        count = total < size ? total : size;
+        for (uint8_t i = 0; i < count; i++) {
+            points[i].range = scale(current[i].range, rangeStep, 65535);
+            points[i].magnitude = scale(current[i].magnitude, magnitudeStep, 65535);
+            points[i].velocity = current[i].velocity < 0 ? -static_cast<int32_t>(scale(-current[i].velocity, velocityStep, 32768))
+                                                         : static_cast<int32_t>(scale(current[i].velocity, velocityStep, 32767));
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Forget the previous frame, so only a keyframe is decoded next
+     */
+    void reset(void) { synchronised = false; }
+
+    /**
+     * @brief Get the number of frames decoded
+     */
+    uint32_t getFrameCount(void) const { return frames; }
+
+    /**
+     * @brief Get the number of delta frames skipped while waiting for a keyframe
+     */
+    uint32_t getSkippedCount(void) const { return skipped; }
+
+    /**
+     * @brief Get the number of frames missing from the sequence, as far as it tells (up to 127 at a time)
+     */
+    uint32_t getMissingCount(void) const { return missing; }
+
+    /**
+     * @brief Get the number of frames that weren't valid
+     */
+    uint32_t getMalformedCount(void) const { return malformed; }
+
+private:
+    static uint16_t scale(const uint32_t steps, const uint8_t step, const uint16_t limit) {
+        const uint32_t value = steps * step;
+        return value > limit ? limit : value;
+    }
+
+    uint8_t rangeStep;
+    uint8_t velocityStep;
+    uint8_t magnitudeStep;
+
+    DFR_RadarCloudFormat::Quantised previous[MaxPoints];
+    uint8_t previousCount;
+
+    uint8_t expected;
+    bool synchronised;
+
+    uint32_t frames;
+    uint32_t skipped;
+    uint32_t missing;
+    uint32_t malformed;
+};
+
+#endif
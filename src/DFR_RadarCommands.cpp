@@ -0,0 +1,12 @@
+/**
+  * @file       DFR_RadarCommands.cpp
+  * @brief      Compile-time descriptions of the sensor's configuration commands
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+#include <DFR_RadarCommands.h>
+
+
+// Commands are passed around by reference, so the table needs a definition
+constexpr DFR_RadarCommand DFR_RadarCommands::table[];
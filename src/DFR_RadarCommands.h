@@ -0,0 +1,231 @@
+/**
+  * @file       DFR_RadarCommands.h
+  * @brief      Compile-time descriptions of the sensor's configuration commands
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarCommands_H_
+#define DFR_RadarCommands_H_
+
+#include <Arduino.h>
+
+
+/**
+ * @brief One argument of a command: the range it must be in, and how it's written
+ */
+struct DFR_RadarArgument {
+    float minimum;
+    float maximum;
+
+    /**
+     * @brief Number of decimals to send; 0 for whole numbers
+     */
+    uint8_t decimals;
+
+    /**
+     * @brief Longest this argument can be once formatted
+     */
+    constexpr size_t width() const {
+        return (minimum < 0 ? 1 : 0)
+            + digits(static_cast<unsigned long>(-minimum > maximum ? -minimum : maximum))
+            + (decimals ? decimals + 1 : 0);
+    }
+
+    static constexpr size_t digits(const unsigned long value) {
+        return value < 10 ? 1 : 1 + digits(value / 10);
+    }
+};
+
+/**
+ * @brief Everything needed to build, validate and parse one of the sensor's commands
+ *
+ * @details A setter has arguments and no response fields; a getter has response fields, and
+ *          may have arguments that select what it reports on (e.g. which GPIO pin).
+ */
+struct DFR_RadarCommand {
+    static constexpr uint8_t maxArguments = 4;
+
+    /**
+     * @brief The command itself, e.g. "setRange"
+     */
+    const char *name;
+
+    /**
+     * @brief How many leading arguments select *what* is being set rather than its value
+     *        (e.g. the output channel of `setUartOutput`), so two commands with the same
+     *        key arguments change the same setting
+     */
+    uint8_t keyArguments;
+
+    uint8_t argumentCount;
+    DFR_RadarArgument arguments[maxArguments];
+
+    /**
+     * @brief Number of whitespace-separated fields in the response (0 for setters)
+     */
+    uint8_t fieldCount;
+
+    /**
+     * @brief Longest any one of those fields may be
+     */
+    uint8_t fieldWidth;
+
+    /**
+     * @brief What the response line starts with; empty to take the first line that isn't an echo,
+     *        prompt or status
+     */
+    const char *responsePrefix;
+
+    /**
+     * @brief How many rows further down the table the getter that reads back what this setter
+     *        sets is; 0 if it can't be read back (and for getters)
+     *
+     * @details The getter takes the setter's key arguments, and its response fields line up
+     *          with the setter's arguments.
+     */
+    int8_t query;
+
+    /**
+     * @brief The getter that reads back what this setter sets, or nullptr (see `query`)
+     */
+    const DFR_RadarCommand *getQuery() const { return query ? this + query : nullptr; }
+
+    /**
+     * @brief Longest this command can be once formatted, not counting the terminator
+     */
+    constexpr size_t length() const {
+        return textLength(name) + argumentsLength(0);
+    }
+
+    /**
+     * @brief Longest the response line can be, not counting the terminator
+     */
+    constexpr size_t responseLength() const {
+        return fieldCount ? textLength(responsePrefix) + fieldCount * (fieldWidth + 1) : 0;
+    }
+
+    constexpr size_t argumentsLength(const uint8_t i) const {
+        return i < argumentCount ? 1 + arguments[i].width() + argumentsLength(i + 1) : 0;
+    }
+
+    static constexpr size_t textLength(const char *text) {
+        return *text ? 1 + textLength(text + 1) : 0;
+    }
+};
+
+/**
+ * @brief The longest of a table's commands (or with `responses`, of their response lines), for
+ *        sizing buffers at compile time
+ */
+template<size_t Count>
+constexpr size_t DFR_RadarLongest(const DFR_RadarCommand (&rows)[Count], const bool responses, const size_t i = 0,
+                                  const size_t longest = 0) {
+    return i == Count ? longest : DFR_RadarLongest(rows, responses, i + 1,
+        (responses ? rows[i].responseLength() : rows[i].length()) > longest
+            ? (responses ? rows[i].responseLength() : rows[i].length()) : longest);
+}
+
+/**
+ * @brief A command together with the arguments to send with it
+ */
+struct DFR_RadarCommandValues {
+    const DFR_RadarCommand *command;
+    float arguments[DFR_RadarCommand::maxArguments];
+};
+
+/**
+ * @brief The commands this library knows, one row each.
+ *
+ * @details Buffer sizes throughout the library are derived from this table, and a setter's
+ *          row says where its getter is, so adding a command only takes a new row here; it can
+ *          then be sent with `DFR_RadarT::set()` or `DFR_RadarT::get()` straight away (give it
+ *          a name below to refer to it by one).
+ *
+ * @link [LeapMMW HS2xx3A v1.3 Manual](https://www.leapmmw.com/wp-content/uploads/1609/47/%E7%94%A8%E6%88%B7%E6%89%8B%E5%86%8CV1.3%EF%BC%9AHS2xx3A%E7%B3%BB%E5%88%97%E4%BA%BA%E5%AD%98%E5%9C%A8%E6%A3%80%E6%B5%8B%E6%A8%A1%E5%9D%97.pdf)
+ */
+struct DFR_RadarCommands {
+    /*
+     * `setUartOutput` parameters:
+     *    | Parameter | Value | Description
+     * ---|-----------|-------|------------
+     *  1 | Type      |  1-2  | 1=Detection, 2=Point cloud
+     *  2 | Enabled   |  0-1  | 0=Disabled, 1=Enabled
+     *  3 | Data Mode |  0-1  | 0=Passive(getOutput only), 1=Active
+     *  4 | Period    | 1501  | Frequency of active output
+     *
+     * Serial data output mode and period, with the period unit being second:
+     *   (1) When par4 is set between 0.025 and 1500:
+     *       - The value represents the period of actively outputting data.
+     *       - When par3 = 0, data is actively outputted based on the period set by
+     *                        par4 (default parameter).
+     *       - When par3 = 1, data is outputted immediately when changes occur, or
+     *                        outputted based on the period set by par4 if there's no change.
+     *   (2) When par4 is set to >1500:
+     *       - Data is passively outputted.
+     *       - When par3 = 0, data is not actively outputted and can only be retrieved
+     *                        using the `getOutput` query command.
+     *       - When par3 = 1, data is outputted immediately when changes occur, or
+     *                        not outputted if there's no change.
+     *
+     * @link [DFRobot SEN0521 Manual](https://github.com/user-attachments/files/17264778/sen0521.pdf)
+     */
+
+    //    name              key  args  arguments (min, max, decimals)                          fields  width  response prefix  query
+    static constexpr DFR_RadarCommand table[] = {
+        { "setRange",       0,   2,    { {0, 9.45f, 3}, {0, 9.45f, 3} },                       0,      0,     nullptr,         1 },
+        { "getRange",       0,   0,    { },                                                    2,      6,     "Response ",     0 },
+        { "setSensitivity", 0,   1,    { {0, 9, 0} },                                          0,      0,     nullptr,         1 },
+        { "getSensitivity", 0,   0,    { },                                                    1,      1,     "Response ",     0 },
+        { "setLatency",     0,   2,    { {0, 100, 3}, {0, 1500, 3} },                          0,      0,     nullptr,         1 },
+        { "getLatency",     0,   0,    { },                                                    2,      9,     "Response ",     0 },
+        { "outputLatency",  0,   3,    { {-1, -1, 0}, {0, 65535, 0}, {0, 65535, 0} },          0,      0,     nullptr,         0 },
+        { "setInhibit",     0,   1,    { {0.1f, 255, 3} },                                     0,      0,     nullptr,         1 },
+        { "getInhibit",     0,   0,    { },                                                    1,      9,     "Response ",     0 },
+        { "setGpioMode",    1,   2,    { {0, 2, 0}, {0, 1, 0} },                               0,      0,     nullptr,         1 },
+        { "getGpioMode",    1,   1,    { {0, 2, 0} },                                          2,      1,     "Response ",     0 },
+        { "setUartOutput",  1,   4,    { {1, 3, 0}, {0, 1, 0}, {0, 1, 0}, {0, 65535, 3} },     0,      0,     nullptr,         1 },
+        { "getUartOutput",  1,   1,    { {1, 3, 0} },                                          4,      9,     "Response ",     0 },
+        { "setLedMode",     1,   2,    { {1, 1, 0}, {0, 1, 0} },                               0,      0,     nullptr,         1 },
+        { "getLedMode",     1,   1,    { {1, 1, 0} },                                          2,      1,     "Response ",     0 },
+        { "setEcho",        0,   1,    { {0, 1, 0} },                                          0,      0,     nullptr,         1 },
+        { "getEcho",        0,   0,    { },                                                    1,      1,     "Response ",     0 },
+        { "getHWV",         0,   0,    { },                                                    1,      31,    "",              0 },
+        { "getSWV",         0,   0,    { },                                                    1,      31,    "",              0 }
+    };
+
+    static constexpr size_t commandCount = sizeof(table) / sizeof(table[0]);
+
+    static constexpr const DFR_RadarCommand &setRange       = table[0];
+    static constexpr const DFR_RadarCommand &getRange       = table[1];
+    static constexpr const DFR_RadarCommand &setSensitivity = table[2];
+    static constexpr const DFR_RadarCommand &getSensitivity = table[3];
+    static constexpr const DFR_RadarCommand &setLatency     = table[4];
+    static constexpr const DFR_RadarCommand &getLatency     = table[5];
+    static constexpr const DFR_RadarCommand &outputLatency  = table[6];
+    static constexpr const DFR_RadarCommand &setInhibit     = table[7];
+    static constexpr const DFR_RadarCommand &getInhibit     = table[8];
+    static constexpr const DFR_RadarCommand &setGpioMode    = table[9];
+    static constexpr const DFR_RadarCommand &getGpioMode    = table[10];
+    static constexpr const DFR_RadarCommand &setUartOutput  = table[11];
+    static constexpr const DFR_RadarCommand &getUartOutput  = table[12];
+    static constexpr const DFR_RadarCommand &setLedMode     = table[13];
+    static constexpr const DFR_RadarCommand &getLedMode     = table[14];
+    static constexpr const DFR_RadarCommand &setEcho        = table[15];
+    static constexpr const DFR_RadarCommand &getEcho        = table[16];
+    static constexpr const DFR_RadarCommand &getHWV         = table[17];
+    static constexpr const DFR_RadarCommand &getSWV         = table[18];
+
+    /**
+     * @brief Buffer size that fits any command in the table, including the terminator
+     */
+    static constexpr size_t longestCommand = 1 + DFR_RadarLongest(table, false);
+
+    /**
+     * @brief Buffer size that fits any response line in the table, including the terminator
+     */
+    static constexpr size_t longestResponse = 1 + DFR_RadarLongest(table, true);
+};
+
+#endif
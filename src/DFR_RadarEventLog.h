@@ -0,0 +1,316 @@
+/**
+  * @file       DFR_RadarEventLog.h
+  * @brief      Compact binary log of presence, health, occupancy and point cloud events, written out in whole blocks (e.g. to SD or SPI flash)
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarEventLog_H_
+#define DFR_RadarEventLog_H_
+
+#include <Arduino.h>
+#include <DFR_RadarPointCloud.h>
+
+
+/**
+ * @brief The layout of a log block, shared by the logger and the decoder in `extras/linux/`
+ *
+ * @details A block is `BlockSize` bytes: a header, then records, then zeros up to the end.
+ *          All multi-byte header fields are little-endian.
+ *
+ *              header:  magic (u16, "DR")  version  reserved  sequence (u32)  time (u32, ms)
+ *              record:  tag  delta  [payload]
+ *
+ *          The tag's low nibble is the record type and its high nibble the sensor (0-15).
+ *          The delta is the time in milliseconds since the previous record in the block (or
+ *          since the header's time, for the first), as a varint: 7 bits per byte, least
+ *          significant first, with the top bit set on every byte but the last.  Every block
+ *          stands on its own, so a damaged one doesn't affect the others.
+ */
+struct DFR_RadarEventFormat {
+    enum Type : uint8_t {
+        End = 0,            // No more records in this block
+        PresenceCleared,    // No payload
+        PresenceDetected,   // No payload
+        Health,             // Payload: previous state << 4 | current state
+        Occupancy,          // Payload: occupied zones, sensors reporting, sensors detecting
+        PointCloud          // Payload: points, nearest range (u16, mm), peak magnitude (u16, 0.1 dB)
+    };
+
+    static constexpr uint16_t magic = 'R' << 8 | 'D';
+    static constexpr uint8_t version = 1;
+    static constexpr size_t headerLength = 12;
+
+    // Tag, a delta of up to 32 bits, and the largest payload
+    static constexpr size_t longestRecord = 1 + 5 + 5;
+};
+
+/**
+ * @brief Packs events into fixed-size blocks in RAM and hands each one to a sink when it's
+ *        full, so the storage sees a few large aligned writes instead of many small ones.
+ *
+ *            bool writeBlock(const uint8_t *block, size_t length, void *context) {
+ *                return static_cast<File *>(context)->write(block, length) == length;
+ *            }
+ *
+ *            DFR_RadarEventLog<512> events( writeBlock, &file );
+ *            events.logPresence( 0, true );
+ *
+ * @note Call `flush()` before powering down or removing the card; events still in RAM are lost otherwise.
+ *
+ * @tparam BlockSize Bytes per block; match the storage's sector or page size (e.g. 512 for SD)
+ */
+template<size_t BlockSize = 512>
+class DFR_RadarEventLog {
+public:
+    /**
+     * @brief Writes out one block
+     *
+     * @param block   The block
+     * @param length  Its length (always `BlockSize`)
+     * @param context Whatever was passed to the constructor
+     *
+     * @return false if it couldn't be written; it will be offered again with the next event or `flush()`
+     */
+    typedef bool (*Sink)(const uint8_t *block, size_t length, void *context);
+
+    /**
+     * @brief Constructor
+     *
+     * @param sink    Where full blocks go
+     * @param context Passed to the sink as is
+     */
+    explicit DFR_RadarEventLog(const Sink sink, void *context = nullptr)
+        : sink(sink), context(context), length(0), last(0), pending(false),
+          sequence(0), records(0), blocks(0), dropped(0) {}
+
+    /**
+     * @brief Log a change in a sensor's presence
+     *
+     * @param sensor   The sensor (0-15)
+     * @param presence Whether it now detects presence
+     *
+     * @return false if the event was dropped because the previous block couldn't be written out
+     */
+    bool logPresence(const uint8_t sensor, const bool presence) {
+        const DFR_RadarEventFormat::Type type = presence ? DFR_RadarEventFormat::PresenceDetected : DFR_RadarEventFormat::PresenceCleared;
+        return append(type, sensor, nullptr, 0);
+    }
+
+    /**
+     * @brief Log a change in a sensor's health, e.g. from its health callback
+     *
+     * @param sensor   The sensor (0-15)
+     * @param previous The state it was in (0-15)
+     * @param current  The state it is in now (0-15)
+     *
+     * @return false if the event was dropped
+     */
+    bool logHealth(const uint8_t sensor, const uint8_t previous, const uint8_t current) {
+        const uint8_t payload = (previous & 0x0F) << 4 | (current & 0x0F);
+        return append(DFR_RadarEventFormat::Health, sensor, &payload, 1);
+    }
+
+    /**
+     * @brief Log a periodic summary of a space, e.g. from a `DFR_RadarFusion`
+     *
+     * @param space     Which space it is (0-15)
+     * @param zones     Bit mask of the occupied zones
+     * @param reporting Number of sensors with recent readings
+     * @param detecting Number of those detecting presence
+     *
+     * @return false if the event was dropped
+     */
+    bool logOccupancy(const uint8_t space, const uint8_t zones, const uint8_t reporting, const uint8_t detecting) {
+        const uint8_t payload[3] = { zones, reporting, detecting };
+        return append(DFR_RadarEventFormat::Occupancy, space, payload, sizeof(payload));
+    }
+
+    /**
+     * @brief Log a summary of a sensor's point cloud frame: how many points it had, the nearest
+     *        one's range and the strongest one's magnitude (both 0 for an empty frame)
+     *
+     * @param sensor The sensor (0-15)
+     * @param points The frame's points, e.g. from `readPointCloud()`
+     * @param count  The number of points
+     *
+     * @return false if the event was dropped
+     */
+    bool logPointCloud(const uint8_t sensor, const DFR_RadarPoint points[], const uint8_t count) {
+        uint16_t nearest = 0;
+        uint16_t peak = 0;
+
+        for (uint8_t i = 0; i < count; i++) {
+            if (!i || points[i].range < nearest)
+                nearest = points[i].range;
+            if (points[i].magnitude > peak)
+                peak = points[i].magnitude;
+        }
+
+        const uint8_t payload[5] = {
+            count,
+            static_cast<uint8_t>(nearest), static_cast<uint8_t>(nearest >> 8),
+            static_cast<uint8_t>(peak), static_cast<uint8_t>(peak >> 8)
+        };
+
+        return append(DFR_RadarEventFormat::PointCloud, sensor, payload, sizeof(payload));
+    }
+
+    /**
+     * @brief Log a summary of the last frame a `DFR_RadarPointCloud` completed
+     *
+     * @param sensor The sensor (0-15)
+     * @param cloud  The decoder, right after `decode()` or `receivePointCloud()` returned true
+     *
+     * @return false if the event was dropped
+     */
+    bool logPointCloud(const uint8_t sensor, const DFR_RadarPointCloud &cloud) {
+        return logPointCloud(sensor, cloud.getPoints(), cloud.getCount());
+    }
+
+    /**
+     * @brief Write out the current block, even if it isn't full yet
+     *
+     * @return false if the sink failed; the block is kept to try again
+     */
+    bool flush(void) {
+        if (pending && !writeBlock())
+            return false;
+
+        if (length > 0) {
+            pending = true;
+            if (!writeBlock())
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Get the number of events logged so far (written out or still in RAM)
+     */
+    uint32_t getRecordCount(void) const { return records; }
+
+    /**
+     * @brief Get the number of blocks written out so far
+     */
+    uint32_t getBlockCount(void) const { return blocks; }
+
+    /**
+     * @brief Get the number of events dropped because the sink kept failing
+     */
+    uint32_t getDroppedCount(void) const { return dropped; }
+
+    /**
+     * @brief Get the number of bytes used in the current block, header included
+     */
+    size_t getBlockUsage(void) const { return length; }
+
+private:
+    static_assert(BlockSize >= DFR_RadarEventFormat::headerLength + DFR_RadarEventFormat::longestRecord,
+                  "DFR_RadarEventLog blocks must hold at least one record");
+
+    bool append(const uint8_t type, const uint8_t sensor, const uint8_t *payload, const uint8_t payloadLength) {
+        // A full block is waiting on the sink; no room for anything else until it's out
+        if (pending && !writeBlock()) {
+            dropped++;
+            return false;
+        }
+
+        const unsigned long now = millis();
+
+        if (length == 0)
+            startBlock(now);
+
+        uint8_t record[DFR_RadarEventFormat::longestRecord];
+        uint8_t size = 0;
+
+        record[size++] = (sensor & 0x0F) << 4 | type;
+        size += encodeVarint(record + size, now - last);
+
+        for (uint8_t i = 0; i < payloadLength; i++)
+            record[size++] = payload[i];
+
+        // Doesn't fit, so close this block and start the next one with this record
+        if (length + size > BlockSize) {
+            pending = true;
+            if (!writeBlock()) {
+                dropped++;
+                return false;
+            }
+
+            startBlock(now);
+            size = 1 + encodeVarint(record + 1, 0);
+
+            for (uint8_t i = 0; i < payloadLength; i++)
+                record[size++] = payload[i];
+        }
+
+        memcpy(block + length, record, size);
+        length += size;
+        last = now;
+        records++;
+        return true;
+    }
+
+    void startBlock(const unsigned long now) {
+        block[0] = static_cast<uint8_t>(DFR_RadarEventFormat::magic);
+        block[1] = DFR_RadarEventFormat::magic >> 8;
+        block[2] = DFR_RadarEventFormat::version;
+        block[3] = 0;
+        writeLittleEndian(block + 4, sequence);
+        writeLittleEndian(block + 8, now);
+
+        length = DFR_RadarEventFormat::headerLength;
+        last = now;
+    }
+
+    // Hands the block over, zero-padded to its full size
+    bool writeBlock(void) {
+        memset(block + length, DFR_RadarEventFormat::End, BlockSize - length);
+
+        if (!sink(block, BlockSize, context))
+            return false;
+
+        pending = false;
+        length = 0;
+        sequence++;
+        blocks++;
+        return true;
+    }
+
+    static uint8_t encodeVarint(uint8_t *buffer, uint32_t value) {
+        uint8_t size = 0;
+
+        while (value >= 0x80) {
+            buffer[size++] = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+
+        buffer[size++] = static_cast<uint8_t>(value);
+        return size;
+    }
+
+    static void writeLittleEndian(uint8_t *buffer, const uint32_t value) {
+        buffer[0] = value;
+        buffer[1] = value >> 8;
+        buffer[2] = value >> 16;
+        buffer[3] = value >> 24;
+    }
+
+    Sink sink;
+    void *context;
+
+    uint8_t block[BlockSize];
+    size_t length;
+    unsigned long last;
+    bool pending;
+
+    uint32_t sequence;
+    uint32_t records;
+    uint32_t blocks;
+    uint32_t dropped;
+};
+
+#endif
@@ -0,0 +1,362 @@
+/**
+  * @file       DFR_RadarFaultyStream.h
+  * @brief      A Stream decorator that delays and damages what the sensor sends, for measuring how the protocol copes with a bad UART
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarFaultyStream_H_
+#define DFR_RadarFaultyStream_H_
+
+#include <Arduino.h>
+
+
+/**
+ * @brief Sits between the driver and the sensor's port, and injects the faults seen on real
+ *        field wiring into everything received: late responses, lost and corrupted bytes,
+ *        noise bursts, the wrong line endings, repeated lines, and unsolicited `$JYBSS` frames
+ *        in the middle of a response.  Whatever is written goes through untouched.
+ *
+ *            DFR_RadarMemoryPort sensor( "getRange\r\nResponse 0.000 6.000\r\nDone\r\nleapMMW:/>" );
+ *            DFR_RadarFaultyStream<> faulty( sensor );
+ *            faulty.setByteLoss( 0.01 );
+ *            faulty.setDelay( 20, 10 );
+ *
+ *            DFR_Radar radar( &faulty );
+ *
+ * @details Faults are drawn from a seeded pseudo-random sequence, so a run can be repeated
+ *          exactly.  Each probability applies independently, per byte (loss, corruption,
+ *          noise) or per line (repeats, injected frames).  A response's delay is drawn when a
+ *          command has been written, and holds back everything received until it has passed.
+ *
+ * @tparam Capacity Bytes of received data held back at most; keep it larger than the longest response
+ */
+template<size_t Capacity = 256>
+class DFR_RadarFaultyStream : public Stream {
+public:
+    /**
+     * @brief Which line endings the sensor's data arrives with
+     */
+    enum LineEnding : uint8_t {
+        Unchanged,          // As sent (<CR><LF>)
+        CarriageReturn,     // <CR> only
+        LineFeed            // <LF> only
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * @param stream The port the sensor is on (or a `DFR_RadarMemoryPort`)
+     * @param seed   Starting point of the fault sequence (not 0)
+     */
+    explicit DFR_RadarFaultyStream(Stream &stream, const uint32_t seed = 0x2545F491)
+        : stream(stream), state(seed ? seed : 1), head(0), count(0), released(0), held(false), releaseAt(0),
+          lineLength(0), lineEnding(Unchanged),
+          delayBase(0), delayJitter(0), lateChance(0), lateDelay(0),
+          lossChance(0), corruptChance(0), noiseChance(0), noiseLength(0), repeatChance(0), frameChance(0),
+          delayed(0), lost(0), corrupted(0), bursts(0), repeated(0), injected(0) {}
+
+    /**
+     * @brief Delay every response by a random time
+     *
+     * @param base   Shortest delay, in milliseconds
+     * @param jitter Most that's added to it, in milliseconds (uniformly distributed)
+     */
+    void setDelay(const unsigned long base, const unsigned long jitter = 0) {
+        delayBase = base;
+        delayJitter = jitter;
+    }
+
+    /**
+     * @brief Make some responses much later than the rest, e.g. past the driver's timeouts
+     *
+     * @param probability Chance of each response being late (0 to 1)
+     * @param delay       Added to its delay, in milliseconds
+     */
+    void setLateResponses(const float probability, const unsigned long delay) {
+        lateChance = threshold(probability);
+        lateDelay = delay;
+    }
+
+    /**
+     * @brief Drop received bytes
+     *
+     * @param probability Chance of each byte being lost (0 to 1)
+     */
+    void setByteLoss(const float probability) { lossChance = threshold(probability); }
+
+    /**
+     * @brief Flip one bit in received bytes
+     *
+     * @param probability Chance of each byte being corrupted (0 to 1)
+     */
+    void setCorruption(const float probability) { corruptChance = threshold(probability); }
+
+    /**
+     * @brief Insert bursts of random bytes into the received data
+     *
+     * @param probability Chance of a burst before each byte (0 to 1)
+     * @param length      Bytes per burst (up to `maxNoiseLength`)
+     */
+    void setNoise(const float probability, const uint8_t length) {
+        noiseChance = threshold(probability);
+        noiseLength = length;
+
+        if (noiseLength > maxNoiseLength)
+            noiseLength = maxNoiseLength;
+    }
+
+    /**
+     * @brief Change the received line endings
+     */
+    void setLineEnding(const LineEnding lineEnding) { this->lineEnding = lineEnding; }
+
+    /**
+     * @brief Receive some lines twice
+     *
+     * @param probability Chance of each line being repeated (0 to 1)
+     */
+    void setRepeatedLines(const float probability) { repeatChance = threshold(probability); }
+
+    /**
+     * @brief Insert unsolicited detection status frames between received lines, as if the
+     *        sensor were pushing them while answering a command
+     *
+     * @param probability Chance of a frame after each line (0 to 1)
+     */
+    void setInjectedFrames(const float probability) { frameChance = threshold(probability); }
+
+    int available() override {
+        pump();
+        return released;
+    }
+
+    int read() override {
+        pump();
+
+        if (!released)
+            return -1;
+
+        const uint8_t c = buffer[head];
+        head = (head + 1) % Capacity;
+        count--;
+        released--;
+        return c;
+    }
+
+    int peek() override {
+        pump();
+        return released ? buffer[head] : -1;
+    }
+
+    size_t write(const uint8_t c) override {
+        // The end of a command: its response is on the way, so pick how long it takes
+        if (c == '\n')
+            holdResponse();
+
+        return stream.write(c);
+    }
+
+    size_t write(const uint8_t *data, const size_t size) override {
+        const size_t sent = stream.write(data, size);
+
+        if (memchr(data, '\n', size) != nullptr)
+            holdResponse();
+
+        return sent;
+    }
+
+    void flush() override { stream.flush(); }
+
+    using Print::write;
+
+    /**
+     * @brief Get the number of responses that were delayed
+     */
+    uint32_t getDelayedCount(void) const { return delayed; }
+
+    /**
+     * @brief Get the number of bytes dropped
+     */
+    uint32_t getLostCount(void) const { return lost; }
+
+    /**
+     * @brief Get the number of bytes corrupted
+     */
+    uint32_t getCorruptedCount(void) const { return corrupted; }
+
+    /**
+     * @brief Get the number of noise bursts inserted
+     */
+    uint32_t getNoiseCount(void) const { return bursts; }
+
+    /**
+     * @brief Get the number of lines repeated
+     */
+    uint32_t getRepeatedCount(void) const { return repeated; }
+
+    /**
+     * @brief Get the number of `$JYBSS` frames inserted
+     */
+    uint32_t getInjectedCount(void) const { return injected; }
+
+    static constexpr uint8_t maxNoiseLength = 16;
+
+private:
+    static constexpr uint8_t lineCopyLength = 64;
+    static constexpr const char *frame = "$JYBSS,1, , , *";
+
+    // The most a single received byte can turn into: a noise burst, itself, a repeated line, and a frame
+    static constexpr size_t expansion = maxNoiseLength + 1 + lineCopyLength + 16 + 2;
+
+    static_assert(Capacity >= 2 * expansion, "DFR_RadarFaultyStream's Capacity is too small to hold back a whole response");
+
+    static uint32_t threshold(const float probability) {
+        if (probability <= 0)
+            return 0;
+
+        return probability >= 1 ? 0xFFFFFFFF : static_cast<uint32_t>(probability * 4294967295.0);
+    }
+
+    // xorshift32
+    uint32_t nextRandom(void) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    bool chance(const uint32_t odds) { return odds && nextRandom() < odds; }
+
+    void holdResponse(void) {
+        unsigned long delay = delayBase;
+
+        if (delayJitter)
+            delay += nextRandom() % (delayJitter + 1);
+
+        if (chance(lateChance))
+            delay += lateDelay;
+
+        if (!delay)
+            return;
+
+        const unsigned long at = millis() + delay;
+
+        // Never release anything earlier than what's already held back
+        if (!held || static_cast<long>(at - releaseAt) > 0)
+            releaseAt = at;
+
+        held = true;
+        delayed++;
+    }
+
+    // Moves what the sensor has sent so far in, damaging it on the way
+    void pump(void) {
+        if (held && static_cast<long>(millis() - releaseAt) >= 0) {
+            held = false;
+            released = count;
+        }
+
+        while (Capacity - count >= expansion && stream.available() > 0) {
+            const int c = stream.read();
+            if (c < 0)
+                break;
+
+            receive(c);
+        }
+    }
+
+    void receive(uint8_t c) {
+        if ((lineEnding == CarriageReturn && c == '\n') || (lineEnding == LineFeed && c == '\r'))
+            return;
+
+        if (chance(lossChance)) {
+            lost++;
+            return;
+        }
+
+        if (chance(corruptChance)) {
+            c ^= 1 << (nextRandom() & 7);
+            corrupted++;
+        }
+
+        if (chance(noiseChance)) {
+            for (uint8_t i = 0; i < noiseLength; i++)
+                push(nextRandom());
+
+            bursts++;
+        }
+
+        push(c);
+
+        if (lineLength < lineCopyLength)
+            line[lineLength++] = c;
+
+        if (c != (lineEnding == CarriageReturn ? '\r' : '\n'))
+            return;
+
+        if (chance(repeatChance)) {
+            for (uint8_t i = 0; i < lineLength; i++)
+                push(line[i]);
+
+            repeated++;
+        }
+
+        if (chance(frameChance)) {
+            for (const char *p = frame; *p; p++)
+                push(*p);
+
+            if (lineEnding != LineFeed)
+                push('\r');
+            if (lineEnding != CarriageReturn)
+                push('\n');
+
+            injected++;
+        }
+
+        lineLength = 0;
+    }
+
+    void push(const uint8_t c) {
+        buffer[(head + count) % Capacity] = c;
+        count++;
+
+        if (!held)
+            released = count;
+    }
+
+    Stream &stream;
+    uint32_t state;
+
+    uint8_t buffer[Capacity];
+    size_t head;
+    size_t count;
+    size_t released;
+    bool held;
+    unsigned long releaseAt;
+
+    uint8_t line[lineCopyLength];
+    uint8_t lineLength;
+    LineEnding lineEnding;
+
+    unsigned long delayBase;
+    unsigned long delayJitter;
+    uint32_t lateChance;
+    unsigned long lateDelay;
+    uint32_t lossChance;
+    uint32_t corruptChance;
+    uint32_t noiseChance;
+    uint8_t noiseLength;
+    uint32_t repeatChance;
+    uint32_t frameChance;
+
+    uint32_t delayed;
+    uint32_t lost;
+    uint32_t corrupted;
+    uint32_t bursts;
+    uint32_t repeated;
+    uint32_t injected;
+};
+
+#endif
@@ -0,0 +1,457 @@
+/**
+  * @file       DFR_RadarFusion.h
+  * @brief      Combines the presence readings of several DFR_Radar sensors covering one space into a single decision
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarFusion_H_
+#define DFR_RadarFusion_H_
+
+#include <Arduino.h>
+#include <DFR_RadarPoint.h>
+
+
+/**
+ * @brief Fuses the presence readings of up to `Count` sensors into one occupancy decision.
+ *
+ * @details Readings are fed in with `update()` (or `poll()`) whenever they're taken, in any
+ *          order and at any rate.  A reading only counts until it is older than the maximum
+ *          age; a sensor that stops reporting simply drops out of the vote.
+ *
+ *          `update()` takes constant time: the vote totals are kept up to date as readings
+ *          come and go, and readings are kept in the order they arrived, so expiring the
+ *          stale ones only ever looks at the oldest.
+ *
+ *          When a vote is tied, the previous decision stands.
+ *
+ *          With `ZoneOverlap`, a presence reading counts in every zone the sensor covers.  A
+ *          point cloud fed in with `updateFrame()` places each detection by its range instead
+ *          (see `setZoneRange()`), so a person only one sensor can see, outside the overlap,
+ *          doesn't outvote the other sensor about the overlap.
+ *
+ * @tparam Count Number of sensors (at most 254)
+ */
+template<uint8_t Count>
+class DFR_RadarFusion {
+public:
+    /**
+     * @brief How the readings are combined
+     */
+    enum Policy : uint8_t {
+        Any,          // Occupied if any sensor detects presence
+        Majority,     // Occupied if more sensors detect presence than don't
+        Weighted,     // Like Majority, but each sensor's vote counts as much as its weight
+        ZoneOverlap   // Majority within each zone, among the sensors covering it; occupied if any zone is
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * @param policy How the readings are combined
+     * @param maxAge How long in milliseconds a reading counts for
+     */
+    explicit DFR_RadarFusion(const Policy policy = Majority, const unsigned long maxAge = 2000)
+        : policy(policy), maxAge(maxAge), oldest(none), newest(none),
+          freshCount(0), presentCount(0), freshWeight(0), presentWeight(0),
+          occupied(false), occupiedZones(0) {
+        for (uint8_t i = 0; i < Count; i++) {
+            inputs[i].updated = 0;
+            inputs[i].weight = 1;
+            inputs[i].zones = 1;
+            inputs[i].detected = 0;
+            inputs[i].presence = false;
+            inputs[i].fresh = false;
+
+            memset(inputs[i].reach, 0, sizeof(inputs[i].reach));
+        }
+
+        memset(zoneFresh, 0, sizeof(zoneFresh));
+        memset(zonePresent, 0, sizeof(zonePresent));
+    }
+
+    /**
+     * @brief Change how the readings are combined; the readings already taken are kept
+     */
+    void setPolicy(const Policy policy) { this->policy = policy; }
+
+    /**
+     * @brief Change how long a reading counts for
+     *
+     * @param maxAge Time in milliseconds
+     */
+    void setMaxAge(const unsigned long maxAge) { this->maxAge = maxAge; }
+
+    /**
+     * @brief Set how much a sensor's vote counts for with the `Weighted` policy
+     *
+     * @param sensor The sensor's index
+     * @param weight Its weight; 0 leaves it out of the vote
+     *
+     * @return false if there is no such sensor
+     */
+    bool setWeight(const uint8_t sensor, const uint8_t weight) {
+        if (sensor >= Count)
+            return false;
+
+        Input &input = inputs[sensor];
+        if (input.fresh)
+            withdraw(input);
+
+        input.weight = weight;
+
+        if (input.fresh)
+            contribute(input);
+
+        return true;
+    }
+
+    /**
+     * @brief Set which zones a sensor covers, for the `ZoneOverlap` policy.  Sensors whose
+     *        detection areas overlap should share a zone, so they have to agree about it;
+     *        an area only one sensor can see should be a zone of its own.
+     *
+     * @note A sensor's current reading then counts in all of its new zones, as a presence
+     *       reading does, until its next frame.
+     *
+     * @param sensor The sensor's index
+     * @param zones  Bit mask of up to 8 zones; by default, every sensor covers zone 0
+     *
+     * @return false if there is no such sensor
+     */
+    bool setZones(const uint8_t sensor, const uint8_t zones) {
+        if (sensor >= Count)
+            return false;
+
+        Input &input = inputs[sensor];
+        if (input.fresh)
+            withdraw(input);
+
+        input.zones = zones;
+        input.detected = input.presence ? zones : 0;
+
+        if (input.fresh)
+            contribute(input);
+
+        return true;
+    }
+
+    /**
+     * @brief Set how far from a sensor one of its zones reaches, so `updateFrame()` can tell
+     *        which zone each of its detections is in
+     *
+     * @details A detection is placed in the nearest-reaching of the sensor's zones that reaches
+     *          past it.  A zone without a reach (the default) extends to the end of the sensor's
+     *          range and takes whatever is beyond the others; a detection beyond every zone's
+     *          reach is in none of them.  E.g. for two sensors facing each other across a 6 m
+     *          hall, with zone 0 seen only by the first, zone 1 by both and zone 2 only by the
+     *          second:
+     *
+     *              fusion.setZones( 0, 0b011 );
+     *              fusion.setZoneRange( 0, 0, 2000 );   // The first's own 2 m
+     *              fusion.setZoneRange( 0, 1, 4000 );   // The overlap, from its side
+     *              fusion.setZones( 1, 0b110 );
+     *              fusion.setZoneRange( 1, 1, 4000 );
+     *              fusion.setZoneRange( 1, 2, 2000 );   // The second's own 2 m
+     *
+     * @param sensor The sensor's index
+     * @param zone   The zone (0 to 7)
+     * @param reach  How far it extends from the sensor, in millimetres; 0 for no limit
+     *
+     * @return false if there is no such sensor or zone
+     */
+    bool setZoneRange(const uint8_t sensor, const uint8_t zone, const uint16_t reach) {
+        if (sensor >= Count || zone >= zoneCount)
+            return false;
+
+        inputs[sensor].reach[zone] = reach;
+        return true;
+    }
+
+    /**
+     * @brief Feed in a sensor's latest reading
+     *
+     * @param sensor   The sensor's index
+     * @param presence Whether it detects presence
+     *
+     * @return false if there is no such sensor
+     */
+    bool update(const uint8_t sensor, const bool presence) {
+        if (sensor >= Count)
+            return false;
+
+        return record(sensor, presence, presence ? inputs[sensor].zones : 0);
+    }
+
+    /**
+     * @brief Feed in a sensor's latest point cloud; it detects presence if there are any points,
+     *        and with `ZoneOverlap`, only in the zones their ranges fall in (see `setZoneRange()`)
+     *
+     * @param sensor The sensor's index
+     * @param points The frame's points, e.g. from `readPointCloud()`
+     * @param count  The number of points
+     *
+     * @return false if there is no such sensor
+     */
+    bool updateFrame(const uint8_t sensor, const DFR_RadarPoint points[], const uint8_t count) {
+        if (sensor >= Count)
+            return false;
+
+        uint8_t detected = 0;
+        for (uint8_t i = 0; i < count; i++)
+            detected |= zonesAt(inputs[sensor], points[i].range);
+
+        return record(sensor, count > 0, detected);
+    }
+
+    /**
+     * @brief Read a sensor's presence and feed it in
+     *
+     * @param sensor The sensor's index
+     * @param radar  The sensor (anything with a `readPresence(bool &)` method)
+     *
+     * @return true if the sensor could be read
+     */
+    template<typename Radar>
+    bool poll(const uint8_t sensor, Radar &radar) {
+        bool presence = false;
+        if (!radar.readPresence(presence))
+            return false;
+
+        return update(sensor, presence);
+    }
+
+    /**
+     * @brief Decide whether the space is occupied, from the readings that are recent enough
+     *
+     * @return true if it's occupied; false if it isn't, or there are no recent readings at all
+     */
+    bool isOccupied(void) {
+        expire(millis());
+
+        switch (policy) {
+            case Any:
+                occupied = presentCount > 0;
+                break;
+
+            case Majority:
+                occupied = vote(presentCount, freshCount, occupied);
+                break;
+
+            case Weighted:
+                occupied = vote(presentWeight, freshWeight, occupied);
+                break;
+
+            case ZoneOverlap:
+                for (uint8_t zone = 0; zone < zoneCount; zone++) {
+                    const uint8_t bit = 1 << zone;
+
+                    if (vote(zonePresent[zone], zoneFresh[zone], occupiedZones & bit))
+                        occupiedZones |= bit;
+                    else
+                        occupiedZones &= ~bit;
+                }
+
+                occupied = occupiedZones != 0;
+                break;
+        }
+
+        return occupied;
+    }
+
+    /**
+     * @brief Get the zones found occupied by the last `isOccupied()` with the `ZoneOverlap` policy
+     *
+     * @return bit mask of the occupied zones
+     */
+    uint8_t getOccupiedZones(void) const { return occupiedZones; }
+
+    /**
+     * @brief Get the number of sensors whose last reading is recent enough to count
+     */
+    uint8_t getFreshCount(void) const { return freshCount; }
+
+    /**
+     * @brief Get the number of sensors whose last recent reading detected presence
+     */
+    uint8_t getPresentCount(void) const { return presentCount; }
+
+    /**
+     * @brief Check if a sensor's last reading is recent enough to count
+     *
+     * @param sensor The sensor's index
+     */
+    bool isFresh(const uint8_t sensor) const { return sensor < Count && inputs[sensor].fresh; }
+
+private:
+    static constexpr uint8_t zoneCount = 8;
+
+    struct Input {
+        unsigned long updated;
+        uint16_t reach[zoneCount];   // How far each zone extends, in millimetres; 0 for no limit
+        uint8_t weight;
+        uint8_t zones;
+        uint8_t detected;   // The zones it detects presence in
+        bool presence;
+        bool fresh;
+
+        // Neighbours in arrival order, while fresh
+        uint8_t older;
+        uint8_t newer;
+    };
+
+    static_assert(Count > 0 && Count < 255, "DFR_RadarFusion needs between 1 and 254 sensors");
+
+    static constexpr uint8_t none = 255;
+
+    /**
+     * @brief Majority vote; a tie (including no votes at all, which gives false) keeps `previous`
+     */
+    static bool vote(const uint16_t present, const uint16_t total, const bool previous) {
+        if (!total)
+            return false;
+
+        const uint16_t absent = total - present;
+        return present == absent ? previous : present > absent;
+    }
+
+    bool record(const uint8_t sensor, const bool presence, const uint8_t detected) {
+        const unsigned long now = millis();
+        expire(now);
+
+        Input &input = inputs[sensor];
+        if (input.fresh) {
+            withdraw(input);
+            unlink(sensor);
+        }
+
+        input.presence = presence;
+        input.detected = detected;
+        input.updated = now;
+        input.fresh = true;
+
+        contribute(input);
+        append(sensor);
+        return true;
+    }
+
+    /**
+     * @brief The zones a sensor's detection at `range` is in: its nearest-reaching zone that
+     *        reaches past it, or if none does, those without a reach
+     */
+    static uint8_t zonesAt(const Input &input, const uint16_t range) {
+        uint8_t nearest = 0;
+        uint8_t unlimited = 0;
+
+        for (uint8_t zone = 0; zone < zoneCount; zone++) {
+            const uint8_t bit = 1 << zone;
+            if (!(input.zones & bit))
+                continue;
+
+            const uint16_t reach = input.reach[zone];
+            if (!reach)
+                unlimited |= bit;
+            else if (reach >= range && (!nearest || reach < input.reach[nearest - 1]))
+                nearest = zone + 1;
+        }
+
+        return nearest ? 1 << (nearest - 1) : unlimited;
+    }
+
+    void contribute(const Input &input) {
+        freshCount++;
+        freshWeight += input.weight;
+
+        if (input.presence) {
+            presentCount++;
+            presentWeight += input.weight;
+        }
+
+        for (uint8_t zone = 0; zone < zoneCount; zone++) {
+            if (!(input.zones & (1 << zone)))
+                continue;
+
+            zoneFresh[zone]++;
+            if (input.detected & (1 << zone))
+                zonePresent[zone]++;
+        }
+    }
+
+    void withdraw(const Input &input) {
+        freshCount--;
+        freshWeight -= input.weight;
+
+        if (input.presence) {
+            presentCount--;
+            presentWeight -= input.weight;
+        }
+
+        for (uint8_t zone = 0; zone < zoneCount; zone++) {
+            if (!(input.zones & (1 << zone)))
+                continue;
+
+            zoneFresh[zone]--;
+            if (input.detected & (1 << zone))
+                zonePresent[zone]--;
+        }
+    }
+
+    // Drop readings that have grown too old; they're in arrival order, so stop at the first that hasn't
+    void expire(const unsigned long now) {
+        while (oldest != none && now - inputs[oldest].updated > maxAge) {
+            const uint8_t sensor = oldest;
+            withdraw(inputs[sensor]);
+            unlink(sensor);
+            inputs[sensor].fresh = false;
+        }
+    }
+
+    void append(const uint8_t sensor) {
+        inputs[sensor].older = newest;
+        inputs[sensor].newer = none;
+
+        if (newest != none)
+            inputs[newest].newer = sensor;
+        else
+            oldest = sensor;
+
+        newest = sensor;
+    }
+
+    void unlink(const uint8_t sensor) {
+        const uint8_t older = inputs[sensor].older;
+        const uint8_t newer = inputs[sensor].newer;
+
+        if (older != none)
+            inputs[older].newer = newer;
+        else
+            oldest = newer;
+
+        if (newer != none)
+            inputs[newer].older = older;
+        else
+            newest = older;
+    }
+
+    Input inputs[Count];
+
+    Policy policy;
+    unsigned long maxAge;
+
+    uint8_t oldest;
+    uint8_t newest;
+
+    uint8_t freshCount;
+    uint8_t presentCount;
+    uint16_t freshWeight;
+    uint16_t presentWeight;
+
+    uint8_t zoneFresh[zoneCount];
+    uint8_t zonePresent[zoneCount];
+
+    bool occupied;
+    uint8_t occupiedZones;
+};
+
+#endif
@@ -0,0 +1,190 @@
+/**
+  * @file       DFR_RadarHeatmap.h
+  * @brief      A decaying range x velocity grid of point cloud hits, showing where in the detection range people spend time
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarHeatmap_H_
+#define DFR_RadarHeatmap_H_
+
+#include <Arduino.h>
+#include <DFR_RadarPoint.h>
+
+
+/**
+ * @brief Accumulates point cloud frames into a fixed grid of range bins (and optionally
+ *        velocity bins), where older hits fade out exponentially
+ *
+ *            DFR_RadarHeatmap<16, 4> heatmap( 6000, 1500 );   // 0-6 m, -1.5 to +1.5 m/s
+ *
+ *            if( sensor.readPointCloud( points, 16, count ) )
+ *              heatmap.update( points, count );
+ *
+ *            uint8_t image[heatmap.cells];
+ *            heatmap.snapshot( image, sizeof( image ) );
+ *
+ * @details Each cell is a 16-bit count.  Every frame first takes 1/2^decay off every cell
+ *          (rounded up, so cells do get back to 0), then adds `hitWeight` for each point in
+ *          the cell.  A cell hit in every frame settles at about `hitWeight` x 2^decay, and a
+ *          hit fades to half in about 0.7 x 2^decay frames.  All integer arithmetic; the grid
+ *          takes 2 bytes per cell.
+ *
+ * @tparam RangeBins    Number of range bins, from 0 to the maximum range
+ * @tparam VelocityBins Number of velocity bins, from -maximum speed to +maximum speed (1 for range only)
+ */
+template<uint8_t RangeBins = 16, uint8_t VelocityBins = 1>
+class DFR_RadarHeatmap {
+public:
+    static constexpr uint16_t cells = RangeBins * VelocityBins;
+    static constexpr uint16_t hitWeight = 64;
+
+    /**
+     * @brief Constructor
+     *
+     * @param maxRange Range covered by the grid, in millimetres; points beyond it are ignored
+     * @param maxSpeed Speed covered by the grid in either direction, in millimetres per second;
+     *                 faster points are ignored (unused with a single velocity bin)
+     * @param decay    How slowly hits fade; see `setDecay()`
+     */
+    explicit DFR_RadarHeatmap(const uint16_t maxRange = 9000, const uint16_t maxSpeed = 2000, const uint8_t decay = 6)
+        : maxRange(maxRange), maxSpeed(maxSpeed), decay(1), frames(0), hits(0) {
+        setDecay(decay);
+        reset();
+    }
+
+    /**
+     * @brief Change how slowly hits fade
+     *
+     * @param decay Each frame takes 1/2^decay off every cell (1 to 10); hits fade to half in about 0.7 x 2^decay frames
+     */
+    void setDecay(const uint8_t decay) { this->decay = decay < 1 ? 1 : decay > 10 ? 10 : decay; }
+
+    /**
+     * @brief Fade the grid by one frame and add a frame's points
+     *
+     * @param points The frame's points (e.g. from `readPointCloud()`)
+     * @param count  The number of points; 0 for a frame without any, which still fades the grid
+     */
+    void update(const DFR_RadarPoint points[], const uint8_t count) {
+        const uint16_t round = (1 << decay) - 1;
+
+        for (uint16_t i = 0; i < cells; i++)
+            grid[i] -= (grid[i] + round) >> decay;
+
+        for (uint8_t i = 0; i < count; i++) {
+            const int16_t cell = cellOf(points[i]);
+            if (cell < 0)
+                continue;
+
+            grid[cell] = grid[cell] > 0xFFFF - hitWeight ? 0xFFFF : grid[cell] + hitWeight;
+            hits++;
+        }
+
+        frames++;
+    }
+
+    /**
+     * @brief Get one cell's count
+     *
+     * @param rangeBin    The range bin (0 is nearest)
+     * @param velocityBin The velocity bin (0 is fastest approaching)
+     */
+    uint16_t get(const uint8_t rangeBin, const uint8_t velocityBin = 0) const {
+        return rangeBin < RangeBins && velocityBin < VelocityBins ? grid[rangeBin * VelocityBins + velocityBin] : 0;
+    }
+
+    /**
+     * @brief Get the highest count in the grid
+     */
+    uint16_t getPeak(void) const {
+        uint16_t peak = 0;
+
+        for (uint16_t i = 0; i < cells; i++) {
+            if (grid[i] > peak)
+                peak = grid[i];
+        }
+
+        return peak;
+    }
+
+    /**
+     * @brief Copy the grid out as one byte per cell, scaled so the peak is 255; compact enough
+     *        to upload instead of raw frames
+     *
+     * @details Cells are in range order, and by velocity within each range bin (the same order as `get()`).
+     *
+     * @param buffer Where to put it
+     * @param size   Its size; at least `cells`
+     *
+     * @return the number of bytes written (`cells`), or 0 if `buffer` is too small
+     */
+    size_t snapshot(uint8_t *buffer, const size_t size) const {
+        if (size < cells)
+            return 0;
+
+        const uint32_t peak = getPeak();
+
+        for (uint16_t i = 0; i < cells; i++)
+            buffer[i] = peak ? (grid[i] * 255UL + peak / 2) / peak : 0;
+
+        return cells;
+    }
+
+    /**
+     * @brief Get the range where a range bin starts
+     *
+     * @return range in millimetres
+     */
+    uint16_t getBinRange(const uint8_t rangeBin) const { return static_cast<uint32_t>(maxRange) * rangeBin / RangeBins; }
+
+    /**
+     * @brief Get the number of frames accumulated since the last `reset()`
+     */
+    uint32_t getFrameCount(void) const { return frames; }
+
+    /**
+     * @brief Get the number of points that landed in the grid since the last `reset()`
+     */
+    uint32_t getHitCount(void) const { return hits; }
+
+    /**
+     * @brief Clear the grid and its counts
+     */
+    void reset(void) {
+        memset(grid, 0, sizeof(grid));
+        frames = 0;
+        hits = 0;
+    }
+
+private:
+    static_assert(RangeBins > 0 && VelocityBins > 0, "DFR_RadarHeatmap needs at least one bin in each direction");
+
+    // The cell a point lands in, or -1 if it's outside the grid
+    int16_t cellOf(const DFR_RadarPoint &point) const {
+        if (point.range >= maxRange)
+            return -1;
+
+        const uint8_t rangeBin = static_cast<uint32_t>(point.range) * RangeBins / maxRange;
+
+        if (VelocityBins == 1)
+            return rangeBin;
+
+        if (point.velocity <= -static_cast<int32_t>(maxSpeed) || point.velocity >= maxSpeed)
+            return -1;
+
+        const uint8_t velocityBin = static_cast<uint32_t>(point.velocity + maxSpeed) * VelocityBins / (2UL * maxSpeed);
+        return rangeBin * VelocityBins + velocityBin;
+    }
+
+    uint16_t grid[cells];
+    uint16_t maxRange;
+    uint16_t maxSpeed;
+    uint8_t decay;
+
+    uint32_t frames;
+    uint32_t hits;
+};
+
+#endif
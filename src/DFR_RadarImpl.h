@@ -0,0 +1,1719 @@
+/**
+  * @file       DFR_RadarImpl.h
+  * @brief      Implementation of DFR_RadarT; included by DFR_Radar.h, don't include this directly
+  * @copyright  Copyright (c) 2010 DFRobot Co. Ltd. (http://www.dfrobot.com)
+  *             Copyright (c) 2023 Matthew Clark (https://github.com/MaffooClock)
+  * @license    The MIT License (MIT)
+  * @authors    huyujie (yujie.hu@dfrobot.com)
+  *             Matthew Clark
+  * @version    v1.0
+  * @date       2023-11-07
+  * @url        https://github.com/MaffooClock/DFRobot_Radar
+  */
+
+#ifndef DFR_RadarImpl_H_
+#define DFR_RadarImpl_H_
+
+
+template<typename Traits>
+DFR_RadarT<Traits>::DFR_RadarT(Port *s)
+    : debugSerial(false) {
+    sensorUART.attach(s);
+    receiveHead = 0;
+    receiveCount = 0;
+    stamps.clear();
+    tapping.clear();
+    statusSequence = 0;
+    malformedFrames = 0;
+    // isConfigured = false;
+    stopped = false;
+    multiConfig = false;
+    pipelineDepth = 0;
+    pipelineCount = 0;
+    pipelineFailed = false;
+    warmStart = false;
+    dirty = false;
+    deferred.clear();
+    configCache.clear();
+    monitor.clear();
+
+    if (Traits::healthMonitor) {
+        monitor.at(0)->recoveryBackoff = minRecoveryBackoff;
+        monitor.at(0)->threshold = 3;
+    }
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::begin() {
+    /* Not sure if I want to impliment this, keeping it for future consideration...
+
+    unsigned long startTime = millis();
+
+    // Give the sensor time to start up just in case this method is called too soon.
+    //
+    // There's probably a smarter way to do this.  Factory default configuration will
+    // have the sensor dumping out $JYBSS messages once per second, so that could be
+    // an easy way to tell that it's "ready".  But if the sensor is configured to send
+    // these only when queried, or when an presence event occurs, or if the interval
+    // is set too long, then this won't really work.
+    //
+    // Another way might be to send a `sensorStart` and see if 1) it complains about
+    // not being ready, or 2) it responds with "sensor started already" and "Error",
+    // or 3) actually starts?
+
+    while( millis() - startTime < startupDelay )
+      Idle::wait();
+
+    if( !stop() )
+      return false;
+
+    // Disable command echoing (less response data that we have to parse through)
+    sendCommand( comSetEcho );
+
+    // Disable periodic $JYBSS messages (we will query for them)
+    sendCommand( comSetUartOutput );
+
+    if( !saveConfig() )
+      return false;
+
+    if( !start() )
+      return false;
+
+    isConfigured = true;
+
+    */
+
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::begin(const DFR_RadarCommandValues profile[], const uint8_t count, uint32_t &fingerprint) {
+    const uint32_t expected = fingerprintProfile(profile, count);
+    const bool matched = expected && fingerprint == expected;
+
+    fingerprint = 0;
+    warmStart = false;
+
+    if (!expected)
+        return false;
+
+    // Same profile as last time, and the sensor still holds it: nothing to do
+    if (matched && holdsProfile(profile, count)) {
+        if (Log::enabled && debugSerial)
+            Log::printf("Warm start: profile %08lx already in place\n", static_cast<unsigned long>(expected));
+
+        // Recovery needs to know what to re-apply all the same
+        for (uint8_t i = 0; i < count; i++)
+            cacheConfig(profile[i]);
+
+        warmStart = true;
+        fingerprint = expected;
+        return true;
+    }
+
+    if (!factoryReset() || !configBegin())
+        return false;
+
+    bool applied = true;
+    for (uint8_t i = 0; i < count; i++)
+        applied = set(*profile[i].command, profile[i].arguments) && applied;
+
+    if (!configEnd() || !applied)
+        return false;
+
+    fingerprint = expected;
+    return true;
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::setStream(Port *s) {
+    sensorUART.attach(s);
+    receiveCount = 0;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::isReady() const {
+    return sensorUART.attached();
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setDetectionRange(const float rangeStart, const float rangeEnd) {
+    if (rangeEnd < rangeStart)
+        return false;
+
+    const float arguments[] = { rangeStart, rangeEnd };
+    return set(DFR_RadarCommands::setRange, arguments);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getDetectionRange(float &rangeStart, float &rangeEnd) {
+    float fields[2];
+    if (!get(DFR_RadarCommands::getRange, fields))
+        return false;
+
+    rangeStart = fields[0];
+    rangeEnd = fields[1];
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setSensitivity(const uint8_t level) {
+    const float arguments[] = { static_cast<float>(level) };
+    return set(DFR_RadarCommands::setSensitivity, arguments);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getSensitivity(uint8_t &level) {
+    float fields[1];
+    if (!get(DFR_RadarCommands::getSensitivity, fields))
+        return false;
+
+    level = fields[0];
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setTriggerLatency(const float confirmationDelay, const float disappearanceDelay) {
+    const float arguments[] = { confirmationDelay, disappearanceDelay };
+    return set(DFR_RadarCommands::setLatency, arguments);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getTriggerLatency(float &confirmationDelay, float &disappearanceDelay) {
+    float fields[2];
+    if (!get(DFR_RadarCommands::getLatency, fields))
+        return false;
+
+    confirmationDelay = fields[0];
+    disappearanceDelay = fields[1];
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setOutputLatency(const float triggerDelay, const float resetDelay) {
+    // Convert seconds into 25ms units; anything negative or too long is rejected by the table
+    const float arguments[] = {
+        -1,
+        static_cast<float>(floor(triggerDelay * 1000 / 25)),
+        static_cast<float>(floor(resetDelay * 1000 / 25))
+    };
+
+    return set(DFR_RadarCommands::outputLatency, arguments);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::checkPresence() const {
+    bool presence = false;
+    readPresence(presence);
+    return presence;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::readPresence(bool &presence) const {
+    DFR_RadarStatus status;
+    if (!readStatus(status))
+        return false;
+
+    presence = status.presence;
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::readStatus(DFR_RadarStatus &status) const {
+    if (!isResponsive())
+        return false;
+
+    char packet[packetLength] = {0};
+
+    // Factory default settings have $JYBSS messages sent once per second,
+    // but we won't want to wait; this will prompt for status immediately
+    if (Traits::timestamps)
+        stamps.at(0)->line.requested = micros();
+
+    serialWrite(comGetOutput);
+
+    /**
+     * Get the response immediately after sending the command.
+     *
+     * If command echoing is enabled, there should be three lines:
+     *   1. the "getOutput 1" echoed back
+     *   2. a "Done" status
+     *   3. the "leapMMW:/>" response followed by the $JYBSS data we want
+     *
+     * If command echoing is disabled, there should be two lines:
+     *   1. a "Done" status
+     *   2. the $JYBSS data we want
+     *
+     * Factory default is command echoing on (might change this in `begin()`)
+     */
+    size_t length = readLines(packet, sizeof(packet), 3);
+
+    recordResponse(length > 0);
+
+    if (!length)
+        return false;
+
+    /**
+     * Find the frame between "$" and "*" and check every field of it, right
+     * where it is in the packet.
+     *
+     * We're expecting to get something like: $JYBSS,1, , , *
+     */
+    if (!DFR_RadarStatus::parse(packet, length, status)) {
+        malformedFrames++;
+
+        if (Log::enabled && debugSerial)
+            Log::printf("Error: Invalid data %s\n", packet);
+        return false;
+    }
+
+    stamp(status);
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::receiveStatus(DFR_RadarStatus &status) const {
+    char line[packetLength];
+
+    // Only what's already arriving; stop at the first status frame
+    while (received()) {
+        const size_t length = readLine(line, sizeof(line));
+        if (!length)
+            continue;
+
+        if (DFR_RadarStatus::parse(line, length, status)) {
+            if (Traits::timestamps)
+                stamps.at(0)->line.requested = 0;
+
+            stamp(status);
+            return true;
+        }
+
+        // Only lines that look like a status frame count as malformed
+        const char *start = DFR_RadarScan::find(line, length, '$');
+        if (start != nullptr && line + length - start > 5 && memcmp(start + 1, "JYBSS", 5) == 0)
+            malformedFrames++;
+    }
+
+    return false;
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::stamp(DFR_RadarStatus &status) const {
+    status.timestamp = millis();
+    status.sequence = statusSequence++;
+
+    status.timing = lineTiming();
+    if (Traits::timestamps)
+        status.timing.decoded = micros();
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::readPointCloud(DFR_RadarPoint points[], const uint8_t size, uint8_t &count) const {
+    DFR_RadarPointCloud cloud(points, size);
+    const bool success = readPointCloud(cloud);
+
+    count = cloud.getCount();
+    return success;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::readPointCloud(DFR_RadarPointCloud &cloud) const {
+    if (!isResponsive())
+        return false;
+
+    char line[packetLength];
+    const unsigned long startTime = millis();
+    const uint32_t frames = cloud.getFrameCount();
+    const uint32_t malformed = cloud.getMalformedCount();
+    bool kept = false;
+
+    if (Traits::timestamps)
+        stamps.at(0)->line.requested = micros();
+
+    serialWrite(comGetPointCloud);
+
+    /**
+     * After the echo and "Done", the frame follows one point per line, the first
+     * one right after the prompt:
+     *
+     *   leapMMW:/>$JYRPO,2,1,1.524,38.6,-0.310*
+     *   $JYRPO,2,2,3.050,21.4,0.000*
+     */
+    while (!kept && cloud.getFrameCount() == frames && millis() - startTime < readPacketTimeout) {
+        const size_t length = readLines(line, sizeof(line), 1);
+        if (length)
+            kept = cloud.decode(line, length, lineTiming());
+    }
+
+    malformedFrames += cloud.getMalformedCount() - malformed;
+
+    if (Log::enabled && debugSerial && cloud.getMalformedCount() != malformed)
+        Log::printf("Error: Invalid point cloud data\n");
+
+    recordResponse(cloud.getFrameCount() != frames);
+    return kept;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::receivePointCloud(DFR_RadarPointCloud &cloud) const {
+    char line[packetLength];
+    const uint32_t malformed = cloud.getMalformedCount();
+    bool kept = false;
+
+    if (Traits::timestamps)
+        stamps.at(0)->line.requested = 0;
+
+    // Only what's already arriving; stop at the end of a frame, so its points can be used
+    while (!kept && received()) {
+        const size_t length = readLine(line, sizeof(line));
+        if (length)
+            kept = cloud.decode(line, length, lineTiming());
+    }
+
+    malformedFrames += cloud.getMalformedCount() - malformed;
+    return kept;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setLockout(const float time) {
+    const float arguments[] = { time };
+    return set(DFR_RadarCommands::setInhibit, arguments);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getLockout(float &time) {
+    float fields[1];
+    if (!get(DFR_RadarCommands::getInhibit, fields))
+        return false;
+
+    time = fields[0];
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setTriggerLevel(const uint8_t ioPin, const uint8_t triggerLevel) {
+    if (triggerLevel != HIGH && triggerLevel != LOW)
+        return false;
+
+    const float arguments[] = { static_cast<float>(ioPin), static_cast<float>(triggerLevel) };
+    return set(DFR_RadarCommands::setGpioMode, arguments);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setTriggerLevel(const uint8_t triggerLevel) {
+    return setTriggerLevel(2, triggerLevel);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getTriggerLevel(const uint8_t ioPin, uint8_t &triggerLevel) {
+    const float arguments[] = { static_cast<float>(ioPin) };
+    float fields[2];
+    if (!get(DFR_RadarCommands::getGpioMode, fields, arguments))
+        return false;
+
+    triggerLevel = fields[1];
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getTriggerLevel(uint8_t &triggerLevel) {
+    return getTriggerLevel(2, triggerLevel);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setUartOutput(const uint8_t messageType, const bool enable, const bool push, const float period) {
+    const float arguments[] = { static_cast<float>(messageType), static_cast<float>(enable), static_cast<float>(push), period };
+    return set(DFR_RadarCommands::setUartOutput, arguments);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::configureUartDetectionOutput(const bool enable, const bool push, const float period) {
+    return setUartOutput(1, enable, push, period);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::configureUartPointCloudOutput(const bool enable, const bool push, const float period) {
+    return setUartOutput(2, enable, push, period);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getUartOutput(const uint8_t messageType, bool &enable, bool &onChange, float &period) {
+    const float arguments[] = { static_cast<float>(messageType) };
+    float fields[4];
+    if (!get(DFR_RadarCommands::getUartOutput, fields, arguments))
+        return false;
+
+    enable = fields[1] == 1;
+    onChange = fields[2] == 1;
+    period = fields[3];
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getUartDetectionOutput(bool &enable, bool &onChange, float &period) {
+    return getUartOutput(1, enable, onChange, period);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getUartPointCloudOutput(bool &enable, bool &onChange, float &period) {
+    return getUartOutput(2, enable, onChange, period);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setEcho(const bool enable) {
+    const float arguments[] = { static_cast<float>(enable) };
+    return set(DFR_RadarCommands::setEcho, arguments);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getEcho(bool &enable) {
+    float fields[1];
+    if (!get(DFR_RadarCommands::getEcho, fields))
+        return false;
+
+    enable = fields[0] == 1;
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::start() {
+    if (pipelineCount)
+        flushPipeline();
+
+    if (!stopped)
+        return true;
+
+    if (sendCommand(comStart, comFailStarted)) {
+        stopped = false;
+        return true;
+    }
+
+    return false;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::stop() {
+    if (pipelineCount)
+        flushPipeline();
+
+    if (stopped)
+        return true;
+
+    if (sendCommand(comStop, comFailStopped)) {
+        stopped = true;
+        return true;
+    }
+
+    return false;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::reboot() {
+    if (!sendCommand(comResetSystem))
+        return false;
+
+    // The sensor comes back up running, with nothing queued
+    stopped = false;
+    multiConfig = false;
+    pipelineCount = 0;
+
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::disableLED() {
+    return configureLED(true);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::enableLED() {
+    return configureLED(false);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::configureLED(const bool disabled) {
+    const float arguments[] = { 1, static_cast<float>(disabled) };
+    return set(DFR_RadarCommands::setLedMode, arguments);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getLEDMode(bool &disabled) {
+    const float arguments[] = { 1 };
+    float fields[2];
+    if (!get(DFR_RadarCommands::getLedMode, fields, arguments))
+        return false;
+
+    disabled = fields[1] == 1;
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::configBegin() {
+    if (multiConfig)
+        return true;
+
+    if (!stop())
+        return false;
+
+    multiConfig = true;
+    pipelineFailed = false;
+
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::configEnd() {
+    if (!multiConfig)
+        return false;
+
+    multiConfig = false;
+
+    // Send whatever is still queued; failures from earlier bursts are remembered too
+    const bool applied = flushPipeline() && !pipelineFailed;
+    pipelineFailed = false;
+
+    if (!isWriteBack() && !saveConfig())
+        return false;
+
+    if (!start())
+        return false;
+
+    return applied;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setPipelineDepth(const uint8_t depth) {
+    if (depth > maxPipelineDepth)
+        return false;
+
+    // Don't strand anything that was queued under the old depth
+    if (pipelineCount)
+        flushPipeline();
+
+    pipelineDepth = depth;
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setWriteBack(const bool enable, const unsigned long quietWindow) {
+    if (!Traits::writeBack)
+        return !enable;
+
+    Deferred &state = *deferred.at(0);
+    state.quietWindow = quietWindow;
+
+    if (enable == state.enabled)
+        return true;
+
+    state.enabled = enable;
+
+    // Leaving write-back mode shouldn't leave anything unsaved
+    return enable || commit();
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::commit() {
+    // In multi-config mode the sensor is already stopped, and `configEnd()` will re-start it;
+    // whatever is still queued has to be applied (and so marked dirty) before it's saved
+    if (multiConfig && !flushPipeline())
+        return false;
+
+    if (!dirty)
+        return true;
+
+    if (multiConfig)
+        return saveConfig();
+
+    if (!stop())
+        return false;
+
+    const bool saved = saveConfig();
+
+    if (!start())
+        return false;
+
+    return saved;
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::update() {
+    if (Traits::healthMonitor && (monitor.at(0)->health == Unhealthy || monitor.at(0)->health == Recovering)) {
+        recover();
+        return;
+    }
+
+    if (!isWriteBack() || !dirty || multiConfig)
+        return;
+
+    // After a failed commit, wait out another quiet window before trying again
+    Deferred &state = *deferred.at(0);
+    if (millis() - state.lastChange >= state.quietWindow && !commit())
+        state.lastChange = millis();
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::setHealthThreshold(const uint8_t failures) {
+    if (!Traits::healthMonitor)
+        return;
+
+    Monitor &state = *monitor.at(0);
+    state.threshold = failures;
+
+    // With monitoring off, nothing should be held back any more
+    if (!failures) {
+        state.consecutiveFailures = 0;
+        state.recoveryBackoff = minRecoveryBackoff;
+        setHealth(Healthy);
+    }
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::factoryReset() {
+    // Anything still queued would be wiped out by the reset anyway
+    pipelineCount = 0;
+
+    // if( !stop() )
+    //   return false;
+    stop();
+
+    const bool success = sendCommand(comFactoryReset);
+    delay(2000);
+
+    // The factory settings are what's in flash now, and there's nothing left to re-apply
+    if (success) {
+        dirty = false;
+        configCache.clear();
+    }
+
+    return success;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getHWVersion(char *version) {
+    return getVersion(DFR_RadarCommands::getHWV, version);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getSWVersion(char *version) {
+    return getVersion(DFR_RadarCommands::getSWV, version);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::set(const DFR_RadarCommand &command, const float arguments[]) {
+    // Queries don't change anything, and shouldn't end up in the config cache
+    if (command.fieldCount)
+        return false;
+
+    DFR_RadarCommandValues values;
+    if (!prepareCommand(values, command, arguments))
+        return false;
+
+    return setConfig(values);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::get(const DFR_RadarCommand &command, float fields[], const float arguments[]) {
+    if (!command.fieldCount)
+        return false;
+
+    DFR_RadarCommandValues values;
+    if (!prepareCommand(values, command, arguments))
+        return false;
+
+    char response[DFR_RadarCommands::longestResponse];
+    if (!getConfig(values, response)) {
+        if (Log::enabled && debugSerial)
+            Log::printf("Error getting %s\n", command.name);
+        return false;
+    }
+
+    const char *field = response;
+    for (uint8_t i = 0; i < command.fieldCount; i++) {
+        fields[i] = strtof(field, nullptr);
+        field += strlen(field) + 1;
+    }
+
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getVersion(const DFR_RadarCommand &command, char *version) {
+    const DFR_RadarCommandValues values = { &command, {0} };
+
+    char response[DFR_RadarCommands::longestResponse];
+    if (!getConfig(values, response)) {
+        if (Log::enabled && debugSerial)
+            Log::printf("Error getting %s\n", command.name);
+        return false;
+    }
+
+    strcpy(version, response);
+    return true;
+}
+
+template<typename Traits>
+size_t DFR_RadarT<Traits>::readLines(char *buffer, const size_t size, const size_t lineCount) const {
+    const unsigned long startTime = millis();
+    size_t offset = 0, linesLeft = lineCount;
+
+    if (Traits::timestamps)
+        stamps.at(0)->line.firstByte = 0;
+
+    while (linesLeft && millis() - startTime < readPacketTimeout) {
+        if (!fillReceiveBuffer()) {
+            Idle::wait();
+            continue;
+        }
+
+        // Copy everything up to the next <CR> or <LF> in one go (as much as fits)...
+        const char *start = receiveBuffer + receiveHead;
+        const char *delimiter = DFR_RadarScan::findEither(start, receiveCount, '\r', '\n');
+        const size_t chunk = delimiter == nullptr ? receiveCount : delimiter - start;
+        const size_t room = size - 1 - offset;
+        const size_t copied = chunk < room ? chunk : room;
+
+        // The frame starts at its '$', after any echo, "Done" or prompt
+        if (Traits::timestamps) {
+            Stamps &stamped = *stamps.at(0);
+            if (!stamped.line.firstByte && DFR_RadarScan::find(start, chunk, '$') != nullptr)
+                stamped.line.firstByte = stamped.received;
+            stamped.line.lastByte = stamped.received;
+        }
+
+        memcpy(buffer + offset, start, copied);
+        offset += copied;
+
+        // ...then drop a <CR>, or keep an <LF> and count the line
+        uint8_t consumed = chunk;
+        if (delimiter != nullptr) {
+            consumed++;
+
+            if (*delimiter == '\n') {
+                if (offset < size - 1)
+                    buffer[offset++] = '\n';
+                linesLeft--;
+            }
+        }
+
+        receiveHead += consumed;
+        receiveCount -= consumed;
+    }
+
+    buffer[offset] = '\0';
+    return offset;
+}
+
+template<typename Traits>
+size_t DFR_RadarT<Traits>::readLine(char *buffer, const size_t size) const {
+    size_t length = 0;
+    unsigned long lastByte = millis();
+
+    if (Traits::timestamps)
+        stamps.at(0)->line.firstByte = 0;
+
+    while (true) {
+        if (!fillReceiveBuffer()) {
+            if (millis() - lastByte >= comTimeout)
+                break;
+
+            Idle::wait();
+            continue;
+        }
+
+        lastByte = millis();
+
+        // Take everything up to the end of the line, or the end of what's been received so far
+        const char *start = receiveBuffer + receiveHead;
+        const char *end = DFR_RadarScan::find(start, receiveCount, '\n');
+        const size_t chunk = end == nullptr ? receiveCount : end - start;
+        const size_t room = size - 1 - length;
+        const size_t copied = chunk < room ? chunk : room;
+
+        // A frame starts at its '$', which may come long after a prompt on the same line
+        if (Traits::timestamps) {
+            Stamps &stamped = *stamps.at(0);
+            if (!stamped.line.firstByte && DFR_RadarScan::find(start, chunk, '$') != nullptr)
+                stamped.line.firstByte = stamped.received;
+            stamped.line.lastByte = stamped.received;
+        }
+
+        memcpy(buffer + length, start, copied);
+        length += copied;
+
+        const uint8_t consumed = chunk + (end == nullptr ? 0 : 1);
+        receiveHead += consumed;
+        receiveCount -= consumed;
+
+        if (end != nullptr)
+            break;
+    }
+
+    buffer[length] = '\0';
+
+    // The sensor is supposed to terminate lines with <CRLF>, and we stopped at <LF>,
+    // so the last character in the line buffer should be a <CR>.  If so, swap it out
+    // for a null terminator
+    if (length && buffer[length - 1] == '\r')
+        buffer[--length] = '\0';
+
+    if (Log::enabled && debugSerial)
+        Log::printf("Read line: '%s'\n", buffer);
+
+    return length;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::received() const {
+    return receiveCount || sensorUART.available() > 0;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::fillReceiveBuffer() const {
+    if (receiveCount)
+        return true;
+
+    receiveHead = 0;
+    receiveCount = readReceived();
+    return receiveCount;
+}
+
+template<typename Traits>
+uint8_t DFR_RadarT<Traits>::readReceived() const {
+    const uint8_t count = sensorUART.read(receiveBuffer, receiveLength);
+
+    if (Traits::timestamps && count)
+        stamps.at(0)->received = micros();
+
+    if (Traits::tap && tapping.at(0)->output != nullptr && count)
+        mirror(receiveBuffer, count);
+
+    return count;
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::mirror(const char *data, const size_t length) const {
+    Tapping &state = *tapping.at(0);
+
+    if (state.mode == TapEverything) {
+        state.output->write(reinterpret_cast<const uint8_t *>(data), length);
+        return;
+    }
+
+    const char *end = data + length;
+
+    // A frame runs from "$" to the end of its line, possibly across chunks
+    while (data < end) {
+        if (!state.inFrame) {
+            data = DFR_RadarScan::find(data, end - data, '$');
+            if (data == nullptr)
+                return;
+
+            state.inFrame = true;
+        }
+
+        const char *lineEnd = DFR_RadarScan::find(data, end - data, '\n');
+        const char *stop = lineEnd == nullptr ? end : lineEnd + 1;
+
+        state.output->write(reinterpret_cast<const uint8_t *>(data), stop - data);
+
+        if (lineEnd != nullptr)
+            state.inFrame = false;
+
+        data = stop;
+    }
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::discardReceived() const {
+    receiveCount = 0;
+
+    while (readReceived())
+        ;
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::discardUntilQuiet() const {
+    const unsigned long startTime = millis();
+    unsigned long lastByte = startTime;
+
+    receiveCount = 0;
+
+    while (millis() - lastByte < readPacketTimeout && millis() - startTime < comTimeout) {
+        if (readReceived())
+            lastByte = millis();
+        else
+            Idle::wait();
+    }
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::setTap(Print *tap, const TapMode mode) {
+    if (!Traits::tap)
+        return;
+
+    tapping.at(0)->output = tap;
+    tapping.at(0)->mode = mode;
+    tapping.at(0)->inFrame = false;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::inject(const char *command) {
+    if (!sensorUART.attached())
+        return false;
+
+    // The library's own queued commands go first; once they're done, nothing of theirs is left
+    if (pipelineCount && !flushPipeline())
+        return false;
+
+    // Whatever was left over belongs to the library's last command, not this one
+    discardReceived();
+    serialWrite(command, false);
+    return readReply();
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::drain() {
+    if (pipelineCount)
+        flushPipeline();
+
+    discardReceived();
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::readReply() const {
+    const size_t promptLength = strlen(comPrompt);
+    const unsigned long startTime = millis();
+    unsigned long lastByte = startTime;
+
+    // Only the start of each line matters: a prompt, then "Done" or "Error"
+    char line[16];
+    uint8_t length = 0;
+    bool answered = false;
+
+    receiveCount = 0;
+
+    while (millis() - startTime < comTimeout) {
+        const uint8_t count = readReceived();
+
+        if (!count) {
+            // With echo off, there's no prompt to wait for
+            if (answered && millis() - lastByte >= readPacketTimeout)
+                return true;
+
+            Idle::wait();
+            continue;
+        }
+
+        lastByte = millis();
+
+        for (uint8_t i = 0; i < count; i++) {
+            const char c = receiveBuffer[i];
+
+            if (c != '\n') {
+                if (length < sizeof(line))
+                    line[length++] = c;
+
+                if (!answered || length != promptLength || strncmp(comPrompt, line, promptLength) != 0)
+                    continue;
+
+                // Leave what came after the prompt for the library
+                receiveHead = i + 1;
+                receiveCount = count - i - 1;
+                return true;
+            }
+
+            const char *text = line;
+            uint8_t textLength = length;
+            if (textLength >= promptLength && strncmp(comPrompt, text, promptLength) == 0) {
+                text += promptLength;
+                textLength -= promptLength;
+            }
+
+            const size_t successLength = strlen(comResponseSuccess);
+            const size_t failLength = strlen(comResponseFail);
+
+            if ((textLength >= successLength && strncmp(comResponseSuccess, text, successLength) == 0)
+                || (textLength >= failLength && strncmp(comResponseFail, text, failLength) == 0))
+                answered = true;
+
+            length = 0;
+        }
+    }
+
+    return answered;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::setConfig(const DFR_RadarCommandValues &values) {
+    if (multiConfig) {
+        if (pipelineDepth > 1)
+            return queueCommand(values);
+
+        if (!sendConfig(values))
+            return false;
+
+        markDirty();
+        cacheConfig(values);
+        return true;
+    }
+    // if( !stop() )
+    //   return false;
+    stop();
+
+    if (!sendConfig(values))
+        return false;
+
+    markDirty();
+    cacheConfig(values);
+
+    // In write-back mode, saving is left to `commit()` or `update()`
+    if (isWriteBack())
+        return start();
+
+    const bool saved = saveConfig();
+
+    if (!start())
+        return false;
+
+    return saved;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::sendConfig(const DFR_RadarCommandValues &values) const {
+    char command[commandLength];
+    formatCommand(command, values);
+    return sendCommand(command);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::saveConfig() {
+    if (!dirty)
+        return true;
+
+    if (!sendCommand(comSaveCfg))
+        return false;
+
+    dirty = false;
+    return true;
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::markDirty() {
+    dirty = true;
+
+    if (Traits::writeBack)
+        deferred.at(0)->lastChange = millis();
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::cacheConfig(const DFR_RadarCommandValues &values) {
+    if (!configCacheSlots)
+        return;
+
+    // Replace the cached command for the same setting, or else take the first free slot
+    DFR_RadarCommandValues *slot = nullptr;
+    for (uint8_t i = 0; i < configCacheSlots; i++) {
+        DFR_RadarCommandValues *cached = configCache.at(i);
+
+        if (cached->command == nullptr) {
+            if (slot == nullptr)
+                slot = cached;
+            continue;
+        }
+
+        if (sameSetting(*cached, values)) {
+            slot = cached;
+            break;
+        }
+    }
+
+    if (slot == nullptr) {
+        if (Log::enabled && debugSerial)
+            Log::printf("Config cache full, not caching '%s'\n", values.command->name);
+        return;
+    }
+
+    *slot = values;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::sameSetting(const DFR_RadarCommandValues &a, const DFR_RadarCommandValues &b) {
+    if (a.command != b.command)
+        return false;
+
+    for (uint8_t i = 0; i < a.command->keyArguments; i++) {
+        if (a.arguments[i] != b.arguments[i])
+            return false;
+    }
+
+    return true;
+}
+
+template<typename Traits>
+uint32_t DFR_RadarT<Traits>::fingerprintProfile(const DFR_RadarCommandValues profile[], const uint8_t count) {
+    uint32_t hash = 2166136261UL;
+
+    for (uint8_t i = 0; i < count; i++) {
+        // Only setters belong in a profile, and every value has to be valid before it can be formatted
+        DFR_RadarCommandValues values;
+        if (profile[i].command == nullptr || profile[i].command->fieldCount || !prepareCommand(values, *profile[i].command, profile[i].arguments))
+            return 0;
+
+        // Hash exactly what would be sent, one line per command
+        char command[commandLength];
+        formatCommand(command, values);
+
+        for (const char *c = command; *c; c++)
+            hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619UL;
+
+        hash = (hash ^ '\n') * 16777619UL;
+    }
+
+    return hash ? hash : 1;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::holdsProfile(const DFR_RadarCommandValues profile[], const uint8_t count) {
+    bool answered = false;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const DFR_RadarCommand &setter = *profile[i].command;
+        const DFR_RadarCommand *getter = setter.getQuery();
+        if (getter == nullptr)
+            continue;
+
+        // The getter takes the key arguments, which lead the setter's arguments
+        float fields[DFR_RadarCommand::maxArguments];
+        if (!get(*getter, fields, profile[i].arguments))
+            return false;
+
+        answered = true;
+
+        for (uint8_t j = 0; j < setter.argumentCount; j++) {
+            const uint8_t decimals = setter.arguments[j].decimals;
+            const float value = profile[i].arguments[j];
+
+            // Compare with what was actually sent, give or take half of its last digit
+            const float sent = !Traits::floatSupport || !decimals ? static_cast<long>(value) : value;
+            float tolerance = 0.5f;
+            for (uint8_t k = 0; k < decimals && Traits::floatSupport; k++)
+                tolerance /= 10;
+
+            if (fabs(fields[j] - sent) >= tolerance) {
+                if (Log::enabled && debugSerial)
+                    Log::printf("Warm start: %s differs\n", setter.name);
+                return false;
+            }
+        }
+    }
+
+    // Nothing could be read back, so at least make sure the sensor is there
+    if (!answered) {
+        bool presence;
+        return readPresence(presence);
+    }
+
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::isResponsive() const {
+    if (!Traits::healthMonitor)
+        return true;
+
+    const Monitor &state = *monitor.at(0);
+    return state.recovering || (state.health != Unhealthy && state.health != Recovering);
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::recordResponse(const bool responded) const {
+    // Recovery keeps its own score
+    if (!Traits::healthMonitor)
+        return;
+
+    Monitor &state = *monitor.at(0);
+    if (!state.threshold || state.recovering)
+        return;
+
+    if (responded) {
+        state.consecutiveFailures = 0;
+        setHealth(Healthy);
+        return;
+    }
+
+    if (state.consecutiveFailures < UINT8_MAX)
+        state.consecutiveFailures++;
+
+    if (state.consecutiveFailures < state.threshold) {
+        setHealth(Degraded);
+        return;
+    }
+
+    state.recoveryTimer = millis();
+    setHealth(Unhealthy);
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::setHealth(const HealthState state) const {
+    if (!Traits::healthMonitor || state == monitor.at(0)->health)
+        return;
+
+    const HealthState previous = monitor.at(0)->health;
+    monitor.at(0)->health = state;
+
+    if (Log::enabled && debugSerial)
+        Log::printf("Health: %u -> %u\n", previous, state);
+
+    if (monitor.at(0)->callback != nullptr)
+        monitor.at(0)->callback(*this, previous, state);
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::recover() {
+    if (!Traits::healthMonitor)
+        return;
+
+    Monitor &state = *monitor.at(0);
+
+    if (state.health == Unhealthy) {
+        if (millis() - state.recoveryTimer < state.recoveryBackoff)
+            return;
+
+        setHealth(Recovering);
+
+        state.recovering = true;
+        const bool rebooted = reboot();
+        state.recovering = false;
+
+        state.recoveryTimer = millis();
+
+        // Give it time to boot before re-applying the configuration
+        if (rebooted)
+            return;
+    } else if (millis() - state.recoveryTimer < startupDelay) {
+        return;
+    } else {
+        state.recovering = true;
+
+        bool applied = stop();
+        for (uint8_t i = 0; applied && i < configCacheSlots; i++) {
+            if (configCache.at(i)->command != nullptr)
+                applied = sendConfig(*configCache.at(i));
+        }
+
+        applied = start() && applied;
+        state.recovering = false;
+
+        if (applied) {
+            state.consecutiveFailures = 0;
+            state.recoveryBackoff = minRecoveryBackoff;
+            setHealth(Healthy);
+            return;
+        }
+    }
+
+    // That attempt failed, so wait longer before the next one
+    state.recoveryBackoff = state.recoveryBackoff >= maxRecoveryBackoff / 2 ? maxRecoveryBackoff : state.recoveryBackoff * 2;
+    state.recoveryTimer = millis();
+    setHealth(Unhealthy);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::queueCommand(const DFR_RadarCommandValues &values) {
+    if (!maxPipelineDepth)
+        return false;
+
+    if (pipelineCount == maxPipelineDepth)
+        flushPipeline();
+
+    *pipeline.at(pipelineCount++) = values;
+    return true;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::flushPipeline() {
+    if (!pipelineCount)
+        return true;
+
+    if (!isResponsive()) {
+        pipelineCount = 0;
+        pipelineFailed = true;
+        return false;
+    }
+
+    char lineBuffer[packetLength] = {0};
+    char command[commandLength];
+    const size_t promptLength = strlen(comPrompt);
+    const uint8_t window = pipelineDepth > 1 ? pipelineDepth : 1;
+    uint8_t written = 0, completed = 0;
+    bool echoed = false;
+    bool success = true;
+    unsigned long lastActivity = millis();
+
+    // Start from an empty receive buffer; after this point nothing can be thrown
+    // away, because it may belong to a command that is already in flight
+    discardReceived();
+
+    while (completed < pipelineCount) {
+        // Keep the window full...
+        while (written < pipelineCount && written - completed < window) {
+            formatCommand(command, *pipeline.at(written++));
+            serialWrite(command, false);
+        }
+
+        // ...and if the sensor has gone quiet, give up on everything in flight
+        if (millis() - lastActivity >= comTimeout) {
+            if (Log::enabled && debugSerial)
+                Log::printf("Pipeline: timed out with %u command(s) in flight\n", written - completed);
+
+            recordResponse(false);
+            success = false;
+            completed = written;
+            echoed = false;
+            lastActivity = millis();
+
+            discardReceived();
+
+            continue;
+        }
+
+        if (!received()) {
+            Idle::wait();
+            continue;
+        }
+
+        readLine(lineBuffer, sizeof(lineBuffer));
+        lastActivity = millis();
+
+        // With echo enabled, the prompt is printed in front of the next command's echo
+        const char *line = lineBuffer;
+        if (strncmp(comPrompt, line, promptLength) == 0)
+            line += promptLength;
+
+        // "Done" or "Error" completes the oldest command in flight
+        if (strncmp(comResponseSuccess, line, strlen(comResponseSuccess)) == 0) {
+            recordResponse(true);
+            markDirty();
+            cacheConfig(*pipeline.at(completed));
+            completed++;
+            echoed = false;
+            continue;
+        }
+
+        if (strncmp(comResponseFail, line, strlen(comResponseFail)) == 0) {
+            if (Log::enabled && debugSerial)
+                Log::printf("Pipeline: '%s' failed\n", pipeline.at(completed)->command->name);
+
+            recordResponse(true);
+            success = false;
+            completed++;
+            echoed = false;
+            continue;
+        }
+
+        // The echo of the command being answered; a second one of the same text can only be
+        // the next identical command's, which means this one's response was lost
+        formatCommand(command, *pipeline.at(completed));
+        if (!echoed && strcmp(command, line) == 0) {
+            echoed = true;
+            continue;
+        }
+
+        // An echo for a command further along means the responses to the ones ahead
+        // of it were lost, so re-synchronize on it and count those as failed
+        uint8_t match = 0, matches = 0;
+        for (uint8_t i = completed + 1; i < written; i++) {
+            formatCommand(command, *pipeline.at(i));
+            if (strcmp(command, line) == 0 && !matches++)
+                match = i;
+        }
+
+        if (matches == 1) {
+            if (Log::enabled && debugSerial)
+                Log::printf("Pipeline: lost %u response(s), resynchronized\n", match - completed);
+
+            success = false;
+            completed = match;
+            echoed = true;
+            continue;
+        }
+
+        // Identical commands in flight, so there's no telling which one this is; give up on
+        // the rest of the batch, and let whatever is still coming for it go by
+        if (matches > 1) {
+            if (Log::enabled && debugSerial)
+                Log::printf("Pipeline: ambiguous echo with %u command(s) in flight, giving up\n", written - completed);
+
+            success = false;
+            discardUntilQuiet();
+            break;
+        }
+
+        // ...anything else is noise
+    }
+
+    pipelineCount = 0;
+
+    if (!success)
+        pipelineFailed = true;
+
+    return success;
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::formatDecimal(char *buffer, const size_t size, const float value, const uint8_t decimals) {
+    if (!Traits::floatSupport || !decimals) {
+        snprintf(buffer, size, "%ld", static_cast<long>(value));
+        return;
+    }
+
+    unsigned long scale = 1;
+    for (uint8_t i = 0; i < decimals; i++)
+        scale *= 10;
+
+    // Work in fixed point so both parts can be printed as integers; this doesn't rely on
+    // float support in `sprintf()` (missing on AVR) or on `dtostrf()` (only on AVR)
+    const long scaled = static_cast<long>(value * scale + (value < 0 ? -0.5f : 0.5f));
+    const unsigned long magnitude = scaled < 0 ? -scaled : scaled;
+
+    snprintf(buffer, size, "%s%lu.%0*lu", scaled < 0 ? "-" : "", magnitude / scale, decimals, magnitude % scale);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::prepareCommand(DFR_RadarCommandValues &values, const DFR_RadarCommand &command, const float *arguments) {
+    values.command = &command;
+
+    for (uint8_t i = 0; i < command.argumentCount; i++) {
+        const DFR_RadarArgument &argument = command.arguments[i];
+        const float value = arguments[i];
+
+        // Written this way round so NaN is rejected too
+        if (!(value >= argument.minimum && value <= argument.maximum))
+            return false;
+
+        if (!argument.decimals && value != static_cast<long>(value))
+            return false;
+
+        values.arguments[i] = value;
+    }
+
+    return true;
+}
+
+template<typename Traits>
+void DFR_RadarT<Traits>::formatCommand(char *buffer, const DFR_RadarCommandValues &values) {
+    const DFR_RadarCommand &command = *values.command;
+
+    // The table sizes `commandLength` for the widest value of every argument, and
+    // `prepareCommand()` made sure none is wider than that
+    size_t length = snprintf(buffer, commandLength, "%s", command.name);
+
+    for (uint8_t i = 0; i < command.argumentCount; i++) {
+        buffer[length++] = ' ';
+        formatDecimal(buffer + length, commandLength - length, values.arguments[i], command.arguments[i].decimals);
+        length += strlen(buffer + length);
+    }
+}
+
+template<typename Traits>
+size_t DFR_RadarT<Traits>::serialWrite(const char *command, const bool exclusive) const {
+    const size_t commandLength = strlen(command) + 2;
+
+    // Clear the receive buffer
+    if (exclusive)
+        discardReceived();
+
+    if (Log::enabled && debugSerial)
+        Log::printf("Sending command: '%s'\n", command);
+
+    // Send the command, properly terminated...
+    sensorUART.write(command);
+    sensorUART.write("\r\n");
+
+    // ...and only wait for it to go out if nothing else is going to follow
+    if (exclusive)
+        sensorUART.flush();
+
+    return commandLength;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::sendCommand(const char *command) const {
+    return sendCommand(command, nullptr);
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::sendCommand(const char *command, const char *acceptableResponse) const {
+    if (!isResponsive())
+        return false;
+
+    bool errorAcceptable = false;
+    char lineBuffer[packetLength] = {0};
+    const unsigned long startTime = millis();
+
+    static const size_t successLength = strlen(comResponseSuccess);
+    static const size_t failLength = strlen(comResponseFail);
+    static const size_t minResponseLength = min(successLength, failLength);
+
+    const size_t commandLength = strlen(command);
+    size_t minLength = min(commandLength, minResponseLength);
+    const size_t acceptableLength = acceptableResponse == nullptr ? minLength : strlen(acceptableResponse);
+
+    if (acceptableResponse != nullptr)
+        minLength = min(acceptableLength, minLength);
+
+    // Send the command...
+    serialWrite(command);
+
+    // ...then wait for a response
+    while (millis() - startTime < comTimeout) {
+        if (!received()) {
+            Idle::wait();
+            continue;
+        }
+
+        // Read a whole line
+        const size_t responseLength = readLine(lineBuffer, sizeof(lineBuffer));
+
+        // We got something shorter than anything we're expecting, so try again
+        if (responseLength < minLength)
+            continue;
+
+        // Check if that line is the command prompt
+        if (strncmp(comPrompt, lineBuffer, strlen(comPrompt)) == 0)
+            continue;
+
+        // ...or if that line is an echo of the original command
+        if (strncmp(command, lineBuffer, commandLength) == 0)
+            continue;
+
+        // ...or if that line contains an expected response
+        if (acceptableResponse != nullptr && strncmp(acceptableResponse, lineBuffer, acceptableLength) == 0) {
+            errorAcceptable = true;
+
+            // Even though we got what we want, we can't return yet; we need to go one more round
+            // so that we get the "Done" or "Error" that follows out of the serial buffer.
+            continue;
+        }
+
+        // ...or if that line says "Done"
+        if (strncmp(comResponseSuccess, lineBuffer, successLength) == 0) {
+            recordResponse(true);
+            return true;
+        }
+
+        // ...or if that line says "Error"
+        if (strncmp(comResponseFail, lineBuffer, failLength) == 0) {
+            recordResponse(true);
+            return errorAcceptable;
+        }
+
+        // ...we got nothing we expected, so try again
+    }
+
+    // We've timed out
+    recordResponse(errorAcceptable);
+    return errorAcceptable;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::getConfig(const DFR_RadarCommandValues &values, char *fields) {
+    static_assert(DFR_RadarCommands::longestResponse <= packetLength,
+        "Traits::packetLength is too small for the longest response in DFR_RadarCommands");
+
+    if (!isResponsive())
+        return false;
+
+    // Anything queued in multi-config mode has to reach the sensor before we ask about it,
+    // and on its own time, not out of the time this command has for its reply
+    if (pipelineCount)
+        flushPipeline();
+
+    const DFR_RadarCommand &command = *values.command;
+    char commandBuffer[commandLength];
+    formatCommand(commandBuffer, values);
+
+    char lineBuffer[packetLength] = {0};
+    const unsigned long startTime = millis();
+
+    static const size_t successLength = strlen(comResponseSuccess);
+    static const size_t failLength = strlen(comResponseFail);
+
+    const size_t echoLength = strlen(commandBuffer);
+    const size_t prefixLength = strlen(command.responsePrefix);
+
+    // Send the command...
+    serialWrite(commandBuffer);
+
+    bool responded = false;
+
+    // ...then wait for a response
+    while (millis() - startTime < comTimeout) {
+        if (!received()) {
+            Idle::wait();
+            continue;
+        }
+
+        // Read a whole line, skipping blank ones
+        if (!readLine(lineBuffer, sizeof(lineBuffer)))
+            continue;
+
+        // Check if that line is the command prompt
+        if (strncmp(comPrompt, lineBuffer, strlen(comPrompt)) == 0)
+            continue;
+
+        // ...or if that line is an echo of the original command
+        if (strncmp(commandBuffer, lineBuffer, echoLength) == 0)
+            continue;
+
+        // ...or if that line says "Done"
+        if (strncmp(comResponseSuccess, lineBuffer, successLength) == 0) {
+            responded = true;
+            continue;
+        }
+
+        // ...or if that line says "Error"
+        if (strncmp(comResponseFail, lineBuffer, failLength) == 0) {
+            responded = true;
+            continue;
+        }
+
+        if (strncmp(command.responsePrefix, lineBuffer, prefixLength) == 0) {
+            recordResponse(true);
+
+            const bool parsed = splitFields(lineBuffer + prefixLength, command, fields);
+            if (!parsed && Log::enabled && debugSerial)
+                Log::printf("getConfig: expected %u field(s) of up to %u characters\n", command.fieldCount, command.fieldWidth);
+
+            return parsed;
+        }
+    }
+    recordResponse(responded);
+    return false;
+}
+
+template<typename Traits>
+bool DFR_RadarT<Traits>::splitFields(const char *line, const DFR_RadarCommand &command, char *fields) {
+    for (uint8_t i = 0; i < command.fieldCount; i++) {
+        while (isWhitespace(*line))
+            line++;
+
+        size_t width = 0;
+        while (line[width] && !isWhitespace(line[width]))
+            width++;
+
+        if (!width || width > command.fieldWidth)
+            return false;
+
+        memcpy(fields, line, width);
+        fields[width] = '\0';
+
+        fields += width + 1;
+        line += width;
+    }
+
+    return true;
+}
+
+#endif
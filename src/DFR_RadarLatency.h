@@ -0,0 +1,196 @@
+/**
+  * @file       DFR_RadarLatency.h
+  * @brief      Timestamps carried by each frame the driver decodes, and a per-stage breakdown of detection latency
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarLatency_H_
+#define DFR_RadarLatency_H_
+
+#include <Arduino.h>
+
+
+/**
+ * @brief When a frame went through each stage of being received, in `micros()`
+ *
+ * @details Filled in by the driver for `readStatus()`, `receiveStatus()` and the point cloud
+ *          reads (see `DFR_RadarPointCloud::getTiming()`), unless `Traits::timestamps` is false,
+ *          in which case it's all 0.  Bytes are stamped as the driver reads them from the port,
+ *          a chunk at a time, so anything that kept the sketch from reading the port (a `delay()`
+ *          in `loop()`, say) shows up as time before the first byte, not in the transfer.
+ */
+struct DFR_RadarTiming {
+    unsigned long requested;    // When the driver sent the query that the frame answers (0 if it was pushed)
+    unsigned long firstByte;    // When its first byte (the '$') was read from the port
+    unsigned long lastByte;     // When its last byte was read
+    unsigned long decoded;      // When it had been parsed and checked
+};
+
+/**
+ * @brief Breaks the latency from presence to action down into stages, to see what the sensor's
+ *        settings, the UART, the library and the sketch each add
+ *
+ *            DFR_RadarLatency latency;
+ *
+ *            if( sensor.receiveStatus( status ) && status.presence != presence ) {
+ *              presence = status.presence;
+ *              digitalWrite( LED_BUILTIN, presence );
+ *              latency.record( status.timing );      // Right after acting on it
+ *            }
+ *
+ *            latency.getStatistics( DFR_RadarLatency::Transfer ).getMean();
+ *
+ * @details The stages, in microseconds:
+ *
+ *              Edge         the frame's first byte, after the sensor's IO pin changed (negative
+ *                           if the UART was first, e.g. with `setOutputLatency()` delaying the pin)
+ *              Response     the first byte, after the query was sent (queried frames only)
+ *              Transfer     the last byte, after the first
+ *              Parse        decoded, after the last byte
+ *              Application  the action, after being decoded
+ *              Total        the action, after the query was sent (or the first byte, if pushed)
+ *
+ *          The sensor's own confirmation delay (`setTriggerLatency()`) comes before anything the
+ *          board can see; to measure it, pass `recordEdge()` the time of a reference detector
+ *          (a PIR, a light barrier, a button pressed on entering) instead of the IO pin.
+ *
+ *          Edges pair with the frames passed to `record()`, so only record the frames that
+ *          changed presence (one per edge); whichever is recorded first waits for the other,
+ *          and they pair if they're within the pairing window either way round.  Each stage
+ *          keeps a count, the minimum, maximum and total: about 130 bytes in all, and no
+ *          floating point.
+ */
+class DFR_RadarLatency {
+public:
+    /**
+     * @brief The stages, in the order a frame goes through them
+     */
+    enum Stage : uint8_t {
+        Edge,
+        Response,
+        Transfer,
+        Parse,
+        Application,
+        Total
+    };
+
+    static constexpr uint8_t stageCount = Total + 1;
+
+    /**
+     * @brief One stage's latencies so far, in microseconds
+     */
+    struct Statistics {
+        uint32_t count;
+        long minimum;
+        long maximum;
+        int64_t sum;
+
+        long getMean(void) const { return count ? static_cast<long>(sum / static_cast<int64_t>(count)) : 0; }
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * @param pairWindow Longest an edge and a frame can be apart and still be paired, in microseconds
+     */
+    explicit DFR_RadarLatency(const unsigned long pairWindow = 2000000UL) : pairWindow(pairWindow) { reset(); }
+
+    /**
+     * @brief Add a frame's stages, e.g. `status.timing` or `cloud.getTiming()`
+     *
+     * @param timing The frame's timestamps; ignored if it wasn't stamped
+     * @param action When the sketch acted on it (by default, now)
+     */
+    void record(const DFR_RadarTiming &timing, const unsigned long action = micros()) {
+        if (!timing.firstByte)
+            return;
+
+        if (timing.requested)
+            add(Response, timing.firstByte - timing.requested);
+
+        add(Transfer, timing.lastByte - timing.firstByte);
+        add(Parse, timing.decoded - timing.lastByte);
+        add(Application, action - timing.decoded);
+        add(Total, action - (timing.requested ? timing.requested : timing.firstByte));
+
+        // The edge was recorded first (though it may have come later), or the frame waits for it
+        const long gap = static_cast<long>(timing.firstByte - pendingEdge);
+        if (edgePending && paired(gap)) {
+            add(Edge, gap);
+            edgePending = false;
+        } else {
+            pendingFrame = timing.firstByte;
+            framePending = true;
+            edgePending = false;
+        }
+    }
+
+    /**
+     * @brief Add an edge of the IO pin (or of a reference detector), to pair with a frame
+     *
+     * @param time `micros()` when it changed, e.g. saved by an interrupt handler
+     */
+    void recordEdge(const unsigned long time) {
+        // The frame was recorded first (though it may have come later), or the edge waits for it
+        const long gap = static_cast<long>(pendingFrame - time);
+        if (framePending && paired(gap)) {
+            add(Edge, gap);
+            framePending = false;
+        } else {
+            pendingEdge = time;
+            edgePending = true;
+            framePending = false;
+        }
+    }
+
+    /**
+     * @brief Get a stage's latencies so far
+     */
+    const Statistics &getStatistics(const Stage stage) const { return statistics[stage]; }
+
+    /**
+     * @brief Get a stage's name, e.g. for a report
+     */
+    static const char *getStageName(const Stage stage) {
+        static const char *const names[stageCount] = { "edge", "response", "transfer", "parse", "application", "total" };
+        return stage < stageCount ? names[stage] : "?";
+    }
+
+    /**
+     * @brief Clear the statistics and anything waiting to be paired, e.g. after changing a setting
+     */
+    void reset(void) {
+        memset(statistics, 0, sizeof(statistics));
+        pendingEdge = 0;
+        pendingFrame = 0;
+        edgePending = false;
+        framePending = false;
+    }
+
+private:
+    bool paired(const long gap) const { return gap <= static_cast<long>(pairWindow) && gap >= -static_cast<long>(pairWindow); }
+
+    void add(const Stage stage, const long latency) {
+        Statistics &s = statistics[stage];
+
+        if (!s.count || latency < s.minimum)
+            s.minimum = latency;
+        if (!s.count || latency > s.maximum)
+            s.maximum = latency;
+
+        s.count++;
+        s.sum += latency;
+    }
+
+    Statistics statistics[stageCount];
+    unsigned long pairWindow;
+
+    unsigned long pendingEdge;
+    unsigned long pendingFrame;
+    bool edgePending;
+    bool framePending;
+};
+
+#endif
@@ -0,0 +1,114 @@
+/**
+  * @file       DFR_RadarPassthrough.h
+  * @brief      Connects a host (e.g. USB serial) to the sensor while the library keeps using it
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarPassthrough_H_
+#define DFR_RadarPassthrough_H_
+
+#include <Arduino.h>
+
+
+/**
+ * @brief A live console on a sensor in service: everything the sensor sends is mirrored to the
+ *        host through the driver's tap, and whole command lines from the host are injected
+ *        between the library's own commands
+ *
+ *            DFR_RadarPassthrough<DFR_Radar> console( sensor, Serial );
+ *            console.begin();
+ *
+ *            void loop() {
+ *              sensor.readPresence( presence );   // The library carries on as usual
+ *              console.run();
+ *            }
+ *
+ * @details Host input is collected a line at a time, so a half-typed command is never split
+ *          by one of the library's.  Lines longer than `LineLength` are dropped.  The driver
+ *          has to be built with `Traits::tap` (as `DFR_Radar` is) for anything to be mirrored.
+ *
+ * @tparam Radar      The sensor's driver (e.g. `DFR_Radar`)
+ * @tparam LineLength Longest command line accepted from the host, terminator included
+ */
+template<typename Radar, uint8_t LineLength = 64>
+class DFR_RadarPassthrough {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param radar The sensor
+     * @param host  Where its output is mirrored to, and commands come from
+     */
+    DFR_RadarPassthrough(Radar &radar, Stream &host)
+        : radar(radar), host(host), length(0), overflowed(false), injected(0), dropped(0) {}
+
+    /**
+     * @brief Start mirroring
+     *
+     * @param mode Everything the sensor sends, or only its frames
+     */
+    void begin(const typename Radar::TapMode mode = Radar::TapEverything) { radar.setTap(&host, mode); }
+
+    /**
+     * @brief Stop mirroring
+     */
+    void end(void) { radar.setTap(nullptr); }
+
+    /**
+     * @brief Send the host's complete command lines to the sensor, then mirror whatever the
+     *        sensor has sent since the library last read; call it from `loop()`
+     *
+     * @note It drains the sensor's output, so don't combine it with `receivePointCloud()`.
+     */
+    void run(void) {
+        while (host.available() > 0) {
+            const char c = host.read();
+
+            if (c == '\r' || c == '\n') {
+                if (overflowed)
+                    dropped++;
+                else if (length) {
+                    line[length] = '\0';
+                    if (radar.inject(line))
+                        injected++;
+                }
+
+                length = 0;
+                overflowed = false;
+                continue;
+            }
+
+            if (length < LineLength - 1)
+                line[length++] = c;
+            else
+                overflowed = true;
+        }
+
+        radar.drain();
+    }
+
+    /**
+     * @brief Get the number of host commands sent to the sensor
+     */
+    uint32_t getInjectedCount(void) const { return injected; }
+
+    /**
+     * @brief Get the number of host commands dropped for being too long
+     */
+    uint32_t getDroppedCount(void) const { return dropped; }
+
+private:
+    Radar &radar;
+    Stream &host;
+
+    char line[LineLength];
+    uint8_t length;
+    bool overflowed;
+
+    uint32_t injected;
+    uint32_t dropped;
+};
+
+#endif
@@ -0,0 +1,185 @@
+/**
+  * @file       DFR_RadarPoint.cpp
+  * @brief      One point of the sensor's point cloud output ($JYRPO) and a validating parser for it
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+#include <DFR_RadarPoint.h>
+#include <DFR_RadarScan.h>
+
+
+/**
+ * @brief Convert a decimal like `-0.310` to an integer in units of 10^-`decimals`, without
+ *        floating point; extra decimal places are truncated
+ *
+ * @return false if it isn't a plain decimal, or doesn't fit in [`minimum`, `maximum`]
+ */
+static bool parseFixed(const char *first, const char *last, const uint8_t decimals, const int32_t minimum, const int32_t maximum, int32_t &value) {
+    const bool negative = first < last && *first == '-';
+    if (negative)
+        first++;
+
+    if (first == last)
+        return false;
+
+    const int32_t limit = negative ? -minimum : maximum;
+    int32_t magnitude = 0;
+    int8_t places = -1;
+    bool digits = false;
+
+    for (const char *c = first; c < last; c++) {
+        if (*c == '.' && places < 0) {
+            places = 0;
+            continue;
+        }
+
+        if (*c < '0' || *c > '9')
+            return false;
+
+        digits = true;
+
+        // Past the precision we keep
+        if (places >= decimals)
+            continue;
+
+        if (places >= 0)
+            places++;
+
+        magnitude = magnitude * 10 + (*c - '0');
+
+        if (magnitude > limit)
+            return false;
+    }
+
+    if (!digits)
+        return false;
+
+    for (int8_t i = places < 0 ? 0 : places; i < decimals; i++)
+        magnitude *= 10;
+
+    value = negative ? -magnitude : magnitude;
+    return value >= minimum && value <= maximum;
+}
+
+/**
+ * @brief Parse a point, converting only as much as it takes to know whether `filter` keeps it
+ *
+ * @param filter What to keep; nullptr to stop after the count and number
+ */
+static DFR_RadarPoint::Result parseFrame(const char *line, const size_t length, DFR_RadarPoint &point, uint8_t &number, uint8_t &count, const DFR_RadarPointFilter *filter) {
+    static const char tag[] = "JYRPO";
+    static constexpr size_t tagLength = sizeof(tag) - 1;
+    static constexpr uint8_t fields = 5;
+
+    const char *start = DFR_RadarScan::find(line, length, '$');
+    if (start == nullptr)
+        return DFR_RadarPoint::Invalid;
+
+    start++;
+    const char *end = DFR_RadarScan::find(start, line + length - start, '*');
+    if (end == nullptr)
+        return DFR_RadarPoint::Invalid;
+
+    // The tag comes first, followed by a comma
+    if (end - start <= static_cast<ptrdiff_t>(tagLength) || memcmp(start, tag, tagLength) != 0 || start[tagLength] != ',')
+        return DFR_RadarPoint::Invalid;
+
+    const char *field = start + tagLength + 1;
+    uint8_t index = 0;
+
+    while (index < fields) {
+        const char *comma = DFR_RadarScan::find(field, end - field, ',');
+        const char *fieldEnd = comma == nullptr ? end : comma;
+
+        // Trim the padding
+        const char *first = field;
+        const char *last = fieldEnd;
+
+        while (first < last && *first == ' ')
+            first++;
+
+        while (last > first && last[-1] == ' ')
+            last--;
+
+        int32_t value = 0;
+
+        // A frame without points leaves everything after the count blank
+        if (index > 0 && count == 0) {
+            if (first != last)
+                return DFR_RadarPoint::Invalid;
+        } else {
+            switch (index) {
+                case 0:
+                    if (!parseFixed(first, last, 0, 0, 255, value))
+                        return DFR_RadarPoint::Invalid;
+                    count = value;
+                    break;
+
+                case 1:
+                    if (!parseFixed(first, last, 0, 1, count, value))
+                        return DFR_RadarPoint::Invalid;
+                    number = value;
+
+                    if (filter == nullptr)
+                        return DFR_RadarPoint::Rejected;
+                    break;
+
+                // From here on, stop as soon as the point is out, without converting the rest
+                case 2:
+                    if (!parseFixed(first, last, 3, 0, 65535, value))
+                        return DFR_RadarPoint::Invalid;
+                    if (value < filter->minRange || value > filter->maxRange)
+                        return DFR_RadarPoint::Rejected;
+                    point.range = value;
+                    break;
+
+                case 3:
+                    if (!parseFixed(first, last, 1, 0, 65535, value))
+                        return DFR_RadarPoint::Invalid;
+                    if (value < filter->minMagnitude)
+                        return DFR_RadarPoint::Rejected;
+                    point.magnitude = value;
+                    break;
+
+                case 4:
+                    if (!parseFixed(first, last, 3, -32768, 32767, value))
+                        return DFR_RadarPoint::Invalid;
+                    if (value < filter->minVelocity || value > filter->maxVelocity)
+                        return DFR_RadarPoint::Rejected;
+                    point.velocity = value;
+                    break;
+            }
+        }
+
+        index++;
+
+        if (comma == nullptr)
+            break;
+
+        field = comma + 1;
+    }
+
+    if (count == 0) {
+        number = 0;
+
+        // A frame without points may stop after the count
+        return index > 0 ? DFR_RadarPoint::Accepted : DFR_RadarPoint::Invalid;
+    }
+
+    return index == fields ? DFR_RadarPoint::Accepted : DFR_RadarPoint::Invalid;
+}
+
+bool DFR_RadarPoint::parse(const char *line, const size_t length, DFR_RadarPoint &point, uint8_t &number, uint8_t &count) {
+    const DFR_RadarPointFilter everything;
+    return parseFrame(line, length, point, number, count, &everything) == Accepted;
+}
+
+DFR_RadarPoint::Result DFR_RadarPoint::parse(const char *line, const size_t length, DFR_RadarPoint &point, uint8_t &number, uint8_t &count, const DFR_RadarPointFilter &filter) {
+    return parseFrame(line, length, point, number, count, &filter);
+}
+
+bool DFR_RadarPoint::parseHeader(const char *line, const size_t length, uint8_t &number, uint8_t &count) {
+    DFR_RadarPoint point;
+    return parseFrame(line, length, point, number, count, nullptr) != Invalid;
+}
@@ -0,0 +1,134 @@
+/**
+  * @file       DFR_RadarPoint.h
+  * @brief      One point of the sensor's point cloud output ($JYRPO) and a validating parser for it
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarPoint_H_
+#define DFR_RadarPoint_H_
+
+#include <Arduino.h>
+
+
+/**
+ * @brief Which points to keep while decoding the point cloud; everything by default
+ *
+ * @details Set only the fields that matter, e.g. to keep points between 0.5 and 4 m:
+ *
+ *              DFR_RadarPointFilter filter;
+ *              filter.minRange = 500;
+ *              filter.maxRange = 4000;
+ */
+struct DFR_RadarPointFilter {
+    DFR_RadarPointFilter()
+        : minRange(0), maxRange(65535), minVelocity(-32768), maxVelocity(32767), minMagnitude(0),
+          maxPoints(255), decimation(1) {}
+
+    /**
+     * @brief Range of interest, in millimetres (inclusive)
+     */
+    uint16_t minRange;
+    uint16_t maxRange;
+
+    /**
+     * @brief Radial velocities of interest, in millimetres per second (inclusive)
+     */
+    int16_t minVelocity;
+    int16_t maxVelocity;
+
+    /**
+     * @brief Weakest reflection kept, in tenths of a dB
+     */
+    uint16_t minMagnitude;
+
+    /**
+     * @brief Most points kept per frame; past that, a point only gets in by replacing a weaker one
+     */
+    uint8_t maxPoints;
+
+    /**
+     * @brief Keep one frame in this many (1 keeps them all)
+     */
+    uint8_t decimation;
+};
+
+/**
+ * @brief One point (target) of the sensor's point cloud, in fixed point
+ *
+ * @details The sensor sends a frame of points as one line per point, e.g.
+ *
+ *              $JYRPO,3,1,1.524,38.6,-0.310*
+ *
+ *          with the number of points in the frame, this point's number (from 1), its range in
+ *          metres, its magnitude in dB and its radial velocity in metres per second (negative
+ *          when approaching).  A frame without points is a single line with a count of 0 and
+ *          the other fields blank.  Fields the sensor adds after these are ignored.
+ */
+struct DFR_RadarPoint {
+    /**
+     * @brief What parsing a line with a filter found
+     */
+    enum Result : uint8_t {
+        Invalid,    // No complete, valid point (or empty frame) in the line
+        Rejected,   // A valid frame header, but the filter doesn't want the point
+        Accepted    // A point the filter keeps, or a frame without points
+    };
+
+    /**
+     * @brief Distance from the sensor, in millimetres
+     */
+    uint16_t range;
+
+    /**
+     * @brief Radial velocity, in millimetres per second; negative when approaching
+     */
+    int16_t velocity;
+
+    /**
+     * @brief Strength of the reflection, in tenths of a dB
+     */
+    uint16_t magnitude;
+
+    /**
+     * @brief Parse a point in place, wherever it is in `line` (e.g. after a prompt)
+     *
+     * @details The frame must have the `JYRPO` tag, a point count and number with the number
+     *          no larger than the count, and range, magnitude and velocity as decimals that
+     *          fit the fields above.  Nothing is converted to floating point.
+     *
+     * @param line   The text received
+     * @param length Its length
+     * @param point  Where to put the point (untouched for a frame without points)
+     * @param number This point's number in the frame, from 1 (0 for a frame without points)
+     * @param count  The number of points in the frame
+     *
+     * @return false if there's no complete, valid point in `line` (`point` may be partly filled in)
+     */
+    static bool parse(const char *line, size_t length, DFR_RadarPoint &point, uint8_t &number, uint8_t &count);
+
+    /**
+     * @brief Parse a point in place, and check it against a filter as its fields are converted
+     *
+     * @details Fields are converted in order (range, magnitude, velocity), and parsing stops at
+     *          the first one the filter rejects, so a rejected point costs only what it took to
+     *          reject it.  The rest of a rejected line isn't checked.  `maxPoints` and
+     *          `decimation` are up to the caller (see `DFR_RadarPointCloud`).
+     *
+     * @param filter Which points to keep
+     *
+     * @return whether the line held a point that was kept, one that was rejected, or nothing valid;
+     *         `number` and `count` are set unless it's `Invalid`, and `point` is complete only if it's `Accepted`
+     */
+    static Result parse(const char *line, size_t length, DFR_RadarPoint &point, uint8_t &number, uint8_t &count, const DFR_RadarPointFilter &filter);
+
+    /**
+     * @brief Parse only the point's number and the frame's point count, e.g. to skip a whole frame
+     *
+     * @return false if there's no valid frame header in `line`
+     */
+    static bool parseHeader(const char *line, size_t length, uint8_t &number, uint8_t &count);
+};
+
+#endif
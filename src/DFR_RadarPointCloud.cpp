@@ -0,0 +1,143 @@
+/**
+  * @file       DFR_RadarPointCloud.cpp
+  * @brief      Assembles point cloud frames ($JYRPO) line by line, filtering and decimating as they're decoded
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+#include <DFR_RadarPointCloud.h>
+#include <DFR_RadarScan.h>
+
+
+DFR_RadarPointCloud::DFR_RadarPointCloud(DFR_RadarPoint points[], const uint8_t size)
+    : points(points), size(size), count(0), kept(0), expected(0), weakest(0), decoding(false), skipping(false),
+      timing(), pending(), frames(0), skipped(0), incomplete(0), rejected(0), malformed(0) {}
+
+bool DFR_RadarPointCloud::decode(const char *line, const size_t length) {
+    return decode(line, length, DFR_RadarTiming());
+}
+
+bool DFR_RadarPointCloud::decode(const char *line, const size_t length, const DFR_RadarTiming &received) {
+    const uint8_t capacity = size < filter.maxPoints ? size : filter.maxPoints;
+
+    DFR_RadarPoint point;
+    uint8_t number = 0, total = 0;
+    DFR_RadarPoint::Result result;
+    bool narrowed = false;
+
+    if (skipping) {
+        result = DFR_RadarPoint::parseHeader(line, length, number, total) ? DFR_RadarPoint::Rejected : DFR_RadarPoint::Invalid;
+        narrowed = true;
+    } else if (decoding && capacity && kept == capacity && points[weakest].magnitude < 65535) {
+        // Full, so only something stronger than the weakest point kept can get in
+        DFR_RadarPointFilter stronger = filter;
+        if (stronger.minMagnitude <= points[weakest].magnitude)
+            stronger.minMagnitude = points[weakest].magnitude + 1;
+
+        result = DFR_RadarPoint::parse(line, length, point, number, total, stronger);
+        narrowed = true;
+    } else {
+        result = DFR_RadarPoint::parse(line, length, point, number, total, filter);
+    }
+
+    if (result == DFR_RadarPoint::Invalid) {
+        // Only lines that look like a point cloud frame count; the echo, "Done" and $JYBSS don't
+        const char *start = DFR_RadarScan::find(line, length, '$');
+        if (start != nullptr && line + length - start > 5 && memcmp(start + 1, "JYRPO", 5) == 0)
+            malformed++;
+
+        return false;
+    }
+
+    // The first line of a frame
+    if (number <= 1) {
+        if (decoding)
+            incomplete++;
+
+        startFrame();
+
+        pending.requested = received.requested;
+        pending.firstByte = received.firstByte;
+
+        // It was read for the previous frame's sake; read it again for this one's
+        if (narrowed && !skipping)
+            result = DFR_RadarPoint::parse(line, length, point, number, total, filter);
+    } else if (!decoding || number != expected) {
+        // A line went missing, so the rest of this frame is no use
+        if (decoding)
+            incomplete++;
+
+        decoding = false;
+        return false;
+    }
+
+    expected = number + 1;
+    pending.lastByte = received.lastByte;
+
+    if (!skipping && total) {
+        if (result == DFR_RadarPoint::Accepted && capacity)
+            keep(point, capacity);
+        else
+            rejected++;
+    }
+
+    // The last point closes the frame
+    if (number != total)
+        return false;
+
+    decoding = false;
+    frames++;
+
+    if (skipping) {
+        skipped++;
+        return false;
+    }
+
+    count = kept;
+
+    timing = pending;
+    if (timing.firstByte)
+        timing.decoded = micros();
+
+    return true;
+}
+
+void DFR_RadarPointCloud::reset() {
+    count = 0;
+    kept = 0;
+    timing = DFR_RadarTiming();
+    decoding = false;
+    skipping = false;
+    frames = 0;
+    skipped = 0;
+    incomplete = 0;
+    rejected = 0;
+    malformed = 0;
+}
+
+void DFR_RadarPointCloud::startFrame() {
+    count = 0;
+    kept = 0;
+    expected = 1;
+    decoding = true;
+    skipping = filter.decimation > 1 && frames % filter.decimation != 0;
+}
+
+void DFR_RadarPointCloud::keep(const DFR_RadarPoint &point, const uint8_t capacity) {
+    if (kept < capacity) {
+        points[kept++] = point;
+    } else {
+        // Only a stronger point gets this far; it takes the weakest one's place
+        points[weakest] = point;
+        rejected++;
+    }
+
+    if (kept < capacity)
+        return;
+
+    weakest = 0;
+    for (uint8_t i = 1; i < kept; i++) {
+        if (points[i].magnitude < points[weakest].magnitude)
+            weakest = i;
+    }
+}
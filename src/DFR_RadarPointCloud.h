@@ -0,0 +1,151 @@
+/**
+  * @file       DFR_RadarPointCloud.h
+  * @brief      Assembles point cloud frames ($JYRPO) line by line, filtering and decimating as they're decoded
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarPointCloud_H_
+#define DFR_RadarPointCloud_H_
+
+#include <Arduino.h>
+#include <DFR_RadarLatency.h>
+#include <DFR_RadarPoint.h>
+
+
+/**
+ * @brief Decodes point cloud lines into frames in a buffer you provide, keeping only the points
+ *        a `DFR_RadarPointFilter` wants
+ *
+ *            DFR_RadarPoint points[8];
+ *            DFR_RadarPointCloud cloud( points, 8 );
+ *
+ *            DFR_RadarPointFilter filter;
+ *            filter.maxRange = 4000;     // Nothing past 4 m
+ *            filter.decimation = 5;      // One frame in five
+ *            cloud.setFilter( filter );
+ *
+ *            if( sensor.receivePointCloud( cloud ) )
+ *              heatmap.update( cloud.getPoints(), cloud.getCount() );
+ *
+ * @details Points outside the region of interest, or too weak, are dropped as soon as the field
+ *          that rules them out has been read; the rest of the line isn't converted.  Once a frame
+ *          has `maxPoints` (or the buffer is full), a point only gets in by replacing the weakest
+ *          one kept, and anything no stronger than that is rejected before its velocity is read,
+ *          so a frame ends up with its strongest points.  Frames skipped by decimation are only
+ *          read as far as their point numbers.  Frames that lose a line partway are discarded.
+ */
+class DFR_RadarPointCloud {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param points Where frames are put
+     * @param size   Most points it holds
+     */
+    DFR_RadarPointCloud(DFR_RadarPoint points[], uint8_t size);
+
+    /**
+     * @brief Change which points are kept; best done between frames
+     */
+    void setFilter(const DFR_RadarPointFilter &filter) { this->filter = filter; }
+
+    /**
+     * @brief Decode one line, e.g. from `readLine()` or a `DFR_RadarEpoll` callback
+     *
+     * @param line   The line
+     * @param length Its length
+     *
+     * @return true if it completed a frame that's kept; its points are in `getPoints()` until
+     *         the next frame starts
+     */
+    bool decode(const char *line, size_t length);
+
+    /**
+     * @brief Decode one line, with when it was received, so the frame's timing can be followed
+     *        (the driver's point cloud reads pass this)
+     *
+     * @param line   The line
+     * @param length Its length
+     * @param received When it was requested and its first and last bytes were read; a frame
+     *                 takes the request and first byte of its first line, and the last byte of its last
+     *
+     * @return true if it completed a frame that's kept
+     */
+    bool decode(const char *line, size_t length, const DFR_RadarTiming &received);
+
+    /**
+     * @brief Get the points of the last complete frame, until the next frame starts
+     *
+     * @details In the order received, except that a point replacing a weaker one takes its place.
+     */
+    const DFR_RadarPoint *getPoints(void) const { return points; }
+
+    /**
+     * @brief Get the number of points in the last complete frame (0 once the next frame starts)
+     */
+    uint8_t getCount(void) const { return count; }
+
+    /**
+     * @brief Get when the last complete frame was requested, received and decoded, if its lines
+     *        came with their timing (otherwise it's all 0)
+     */
+    const DFR_RadarTiming &getTiming(void) const { return timing; }
+
+    /**
+     * @brief Get the number of frames that ended so far, kept or skipped
+     */
+    uint32_t getFrameCount(void) const { return frames; }
+
+    /**
+     * @brief Get the number of frames skipped by decimation
+     */
+    uint32_t getSkippedCount(void) const { return skipped; }
+
+    /**
+     * @brief Get the number of frames discarded because a line was lost partway
+     */
+    uint32_t getIncompleteCount(void) const { return incomplete; }
+
+    /**
+     * @brief Get the number of points rejected by the filter, or for being weaker than `maxPoints` others
+     */
+    uint32_t getRejectedCount(void) const { return rejected; }
+
+    /**
+     * @brief Get the number of lines that looked like a frame but weren't valid
+     */
+    uint32_t getMalformedCount(void) const { return malformed; }
+
+    /**
+     * @brief Forget any partly decoded frame and clear the counts
+     */
+    void reset(void);
+
+private:
+    void startFrame(void);
+    void keep(const DFR_RadarPoint &point, uint8_t capacity);
+
+    DFR_RadarPoint *points;
+    uint8_t size;
+    DFR_RadarPointFilter filter;
+
+    uint8_t count;
+    uint8_t kept;
+    uint8_t expected;
+    uint8_t weakest;
+    bool decoding;
+    bool skipping;
+
+    DFR_RadarTiming timing;
+    DFR_RadarTiming pending;
+
+    uint32_t frames;
+    uint32_t skipped;
+    uint32_t incomplete;
+    uint32_t rejected;
+    uint32_t malformed;
+};
+
+#endif
@@ -0,0 +1,73 @@
+/**
+  * @file       DFR_RadarPoller.cpp
+  * @brief      Adaptive presence polling for DFR_Radar sensors left in query mode
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+#include <DFR_RadarPoller.h>
+
+
+DFR_RadarPoller::DFR_RadarPoller(const unsigned long floorInterval, const unsigned long ceilingInterval)
+    : floorInterval(1), ceilingInterval(1), interval(1), lastSample(0), averageGap(0), samples(0), presence(false) {
+    setIntervals(floorInterval, ceilingInterval);
+}
+
+bool DFR_RadarPoller::setIntervals(const unsigned long floorInterval, const unsigned long ceilingInterval) {
+    if (floorInterval < 1 || ceilingInterval < floorInterval)
+        return false;
+
+    this->floorInterval = floorInterval;
+    this->ceilingInterval = ceilingInterval;
+
+    if (interval < floorInterval)
+        interval = floorInterval;
+
+    if (interval > ceilingInterval)
+        interval = ceilingInterval;
+
+    return true;
+}
+
+bool DFR_RadarPoller::isDue() const {
+    return !samples || millis() - lastSample >= interval;
+}
+
+void DFR_RadarPoller::record(const bool success, const bool presence) {
+    const unsigned long now = millis();
+
+    // Keep a running average (1/8 weight) of the measured gaps, in 1/16 ms
+    if (samples) {
+        const uint32_t gap = (now - lastSample) << 4;
+        averageGap = samples == 1 ? gap : averageGap - (averageGap >> 3) + (gap >> 3);
+    }
+
+    if (samples < 2)
+        samples++;
+
+    lastSample = now;
+
+    // Nothing was learned, so don't change pace
+    if (!success)
+        return;
+
+    if (presence != this->presence) {
+        this->presence = presence;
+        interval = floorInterval;
+        return;
+    }
+
+    // The state is stable, so back off
+    interval = interval > ceilingInterval / 2 ? ceilingInterval : interval * 2;
+}
+
+void DFR_RadarPoller::reset() {
+    interval = floorInterval;
+}
+
+float DFR_RadarPoller::getSampleRate() const {
+    if (samples < 2 || !averageGap)
+        return 0;
+
+    return 16000.0f / averageGap;
+}
@@ -0,0 +1,119 @@
+/**
+  * @file       DFR_RadarPoller.h
+  * @brief      Adaptive presence polling for DFR_Radar sensors left in query mode
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarPoller_H_
+#define DFR_RadarPoller_H_
+
+#include <Arduino.h>
+
+
+/**
+ * @brief Decides when a sensor in query mode is worth asking about presence again.
+ *
+ * @details Right after the presence state changes, the sensor is polled at the floor
+ *          interval.  Every sample that agrees with the previous one doubles the interval,
+ *          up to the ceiling, so a room that has been empty (or occupied) for a long time
+ *          costs only an occasional query.  The worst-case extra detection latency is the
+ *          current interval (see `getInterval()`).
+ */
+class DFR_RadarPoller {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param floorInterval   Shortest time in milliseconds between polls (used right after a transition)
+     * @param ceilingInterval Longest time in milliseconds between polls (used while the state is stable)
+     */
+    explicit DFR_RadarPoller(unsigned long floorInterval = 100, unsigned long ceilingInterval = 5000);
+
+    /**
+     * @brief Set the range the polling interval is allowed to move in
+     *
+     * @param floorInterval   Shortest time in milliseconds between polls; must be at least 1
+     * @param ceilingInterval Longest time in milliseconds between polls; must not be less than the floor
+     *
+     * @return false if the intervals are invalid (no changes made), true otherwise
+     */
+    bool setIntervals(unsigned long floorInterval, unsigned long ceilingInterval);
+
+    /**
+     * @brief Query the sensor if it's time to do so.  Call this from `loop()` as often as you like.
+     *
+     * @param sensor  The sensor to poll (anything with a `readPresence(bool &)` method)
+     *
+     * @return true if the sensor was queried on this call (successfully or not)
+     */
+    template<typename Radar>
+    bool poll(Radar &sensor) {
+        if (!isDue())
+            return false;
+
+        bool presence = false;
+        const bool success = sensor.readPresence(presence);
+        record(success, presence);
+        return true;
+    }
+
+    /**
+     * @brief Check if the sensor should be queried now
+     *
+     * @return true if the current interval has elapsed since the last sample
+     */
+    bool isDue(void) const;
+
+    /**
+     * @brief Feed in a sample taken outside of `poll()`, e.g. when the query is scheduled elsewhere
+     *
+     * @param success  Whether the sensor could be read; failed reads leave the interval unchanged
+     * @param presence The presence state that was read
+     */
+    void record(bool success, bool presence);
+
+    /**
+     * @brief Go back to polling at the floor interval, e.g. when something else suggests activity
+     */
+    void reset(void);
+
+    /**
+     * @brief Get the last presence state that was successfully read
+     *
+     * @return true if presence was detected
+     */
+    bool getPresence(void) const { return presence; }
+
+    /**
+     * @brief Get the time the poller currently waits between samples
+     *
+     * @return the current polling interval in milliseconds
+     */
+    unsigned long getInterval(void) const { return interval; }
+
+    /**
+     * @brief Get the rate at which samples are actually being taken
+     *
+     * @note This is a running average of the measured gaps between samples, so it also
+     *       reflects a `loop()` that's too slow to keep up with the floor interval.
+     *
+     * @return samples per second (0 until two samples have been taken)
+     */
+    float getSampleRate(void) const;
+
+private:
+    unsigned long floorInterval;
+    unsigned long ceilingInterval;
+    unsigned long interval;
+    unsigned long lastSample;
+
+    // Running average of the gap between samples, in 1/16 ms
+    uint32_t averageGap;
+
+    uint8_t samples;
+    bool presence;
+};
+
+#endif
@@ -0,0 +1,519 @@
+/**
+  * @file       DFR_RadarPosix.h
+  * @brief      Native Linux backend: drive sensors through a tty (e.g. a USB-UART adapter), many at once with epoll
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * @note Only for Linux builds outside of Arduino; see `extras/linux/` for the core functions it
+  *       builds against, a simulated sensor and an example gateway.
+  */
+
+
+#ifndef DFR_RadarPosix_H_
+#define DFR_RadarPosix_H_
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <Arduino.h>
+#include <DFR_Radar.h>
+#include <DFR_RadarScan.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+
+/**
+ * @brief A serial port on Linux, opened raw and non-blocking
+ *
+ * @details Being a `Stream`, it works with the default transport, but `DFR_RadarPosixTransport`
+ *          reads it in bulk instead of one system call per byte.
+ */
+class DFR_RadarTty : public Stream {
+public:
+    DFR_RadarTty() : descriptor(-1), peeked(-1), hungUp(false) {}
+    ~DFR_RadarTty() { end(); }
+
+    DFR_RadarTty(const DFR_RadarTty &) = delete;
+    DFR_RadarTty &operator=(const DFR_RadarTty &) = delete;
+
+    /**
+     * @brief Open a serial device, e.g. "/dev/ttyUSB0"
+     *
+     * @param path The device to open
+     * @param baud The sensor's baud rate; factory default is 115200
+     *
+     * @return false if the device couldn't be opened or configured
+     */
+    bool begin(const char *path, const unsigned long baud = 115200) {
+        end();
+
+        const int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        if (!adopt(fd, baud)) {
+            close(fd);
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Take over a descriptor that's already open (e.g. one end of a pseudo-terminal),
+     *        configuring it the same way `begin()` would
+     *
+     * @return false if it couldn't be configured (the descriptor is left open)
+     */
+    bool adopt(const int fd, const unsigned long baud = 115200) {
+        termios settings;
+        if (tcgetattr(fd, &settings) != 0)
+            return false;
+
+        cfmakeraw(&settings);
+        settings.c_cflag |= CLOCAL | CREAD;
+        settings.c_cc[VMIN] = 0;
+        settings.c_cc[VTIME] = 0;
+
+        const speed_t speed = baudConstant(baud);
+        if (speed == 0 || cfsetispeed(&settings, speed) != 0 || cfsetospeed(&settings, speed) != 0)
+            return false;
+
+        if (tcsetattr(fd, TCSANOW, &settings) != 0)
+            return false;
+
+        if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0)
+            return false;
+
+        descriptor = fd;
+        peeked = -1;
+        hungUp = false;
+        return true;
+    }
+
+    /**
+     * @brief Close the port
+     */
+    void end() {
+        if (descriptor >= 0)
+            close(descriptor);
+
+        descriptor = -1;
+        peeked = -1;
+        hungUp = false;
+    }
+
+    /**
+     * @brief Get the file descriptor, e.g. to watch it with `poll()` or `DFR_RadarEpoll`
+     */
+    int fd() const { return descriptor; }
+
+    /**
+     * @brief Check if the device has gone away (e.g. the USB-UART adapter was unplugged); only
+     *        `end()` and opening it again get it going
+     */
+    bool isHungUp() const { return hungUp; }
+
+    /**
+     * @brief Number of bytes waiting; if there are none, waits up to `idleWait` milliseconds
+     *        for some, so DFR_Radar's wait loops sleep instead of spinning on the CPU
+     */
+    int available() override {
+        const int ready = pending();
+        if (ready || !waitReadable(idleWait))
+            return ready;
+
+        return pending();
+    }
+
+    int read() override {
+        if (peeked >= 0) {
+            const int c = peeked;
+            peeked = -1;
+            return c;
+        }
+
+        uint8_t c;
+        return readSome(&c, 1) == 1 ? c : -1;
+    }
+
+    int peek() override {
+        if (peeked < 0)
+            peeked = read();
+
+        return peeked;
+    }
+
+    /**
+     * @brief Read whatever has already arrived, up to `length` bytes, in one `read()`
+     *
+     * @return the number of bytes read; 0 if there were none, or the device hung up (see `isHungUp()`)
+     */
+    size_t readAvailable(char *buffer, const size_t length) {
+        if (!length)
+            return 0;
+
+        size_t count = 0;
+        if (peeked >= 0) {
+            buffer[count++] = peeked;
+            peeked = -1;
+        }
+
+        if (count == length)
+            return count;
+
+        const ssize_t got = readSome(buffer + count, length - count);
+        return got > 0 ? count + got : count;
+    }
+
+    size_t write(const uint8_t c) override { return write(&c, 1); }
+
+    size_t write(const uint8_t *buffer, const size_t size) override {
+        size_t written = 0;
+
+        while (written < size) {
+            const ssize_t sent = ::write(descriptor, buffer + written, size - written);
+
+            if (sent > 0) {
+                written += sent;
+                continue;
+            }
+
+            // The output buffer is full, so wait for room rather than dropping the rest
+            if (sent < 0 && (errno == EAGAIN || errno == EINTR) && waitWritable(writeTimeout))
+                continue;
+
+            break;
+        }
+
+        return written;
+    }
+
+    using Print::write;
+
+    void flush() override { tcdrain(descriptor); }
+
+    /**
+     * @brief Longest `available()` waits for data, in milliseconds
+     */
+    static constexpr int idleWait = 1;
+
+    /**
+     * @brief Longest a write waits for room in the output buffer, in milliseconds
+     */
+    static constexpr int writeTimeout = 100;
+
+private:
+    // Raw and non-blocking, an idle tty reads nothing, but so does one that's hung up; only
+    // the latter polls as hung up, or fails outright (e.g. a pseudo-terminal's master with EIO)
+    ssize_t readSome(void *buffer, const size_t length) {
+        const ssize_t got = ::read(descriptor, buffer, length);
+
+        if (got < 0 && errno != EAGAIN && errno != EINTR)
+            hungUp = true;
+        else if (got == 0)
+            waitReadable(0);
+
+        return got;
+    }
+
+    int pending() const {
+        int count = 0;
+        if (ioctl(descriptor, FIONREAD, &count) != 0)
+            return 0;
+
+        return count + (peeked >= 0 ? 1 : 0);
+    }
+
+    bool waitReadable(const int timeout) {
+        pollfd watch = { descriptor, POLLIN, 0 };
+        if (poll(&watch, 1, timeout) <= 0)
+            return false;
+
+        // A hung up port polls as readable too, forever
+        if (watch.revents & (POLLHUP | POLLERR)) {
+            hungUp = true;
+            return false;
+        }
+
+        return watch.revents & POLLIN;
+    }
+
+    bool waitWritable(const int timeout) const {
+        pollfd watch = { descriptor, POLLOUT, 0 };
+        return poll(&watch, 1, timeout) > 0 && (watch.revents & POLLOUT);
+    }
+
+    static speed_t baudConstant(const unsigned long baud) {
+        switch (baud) {
+            case 9600:   return B9600;
+            case 19200:  return B19200;
+            case 38400:  return B38400;
+            case 57600:  return B57600;
+            case 115200: return B115200;
+            case 230400: return B230400;
+            case 460800: return B460800;
+            case 921600: return B921600;
+            default:     return 0;
+        }
+    }
+
+    int descriptor;
+    int peeked;
+    bool hungUp;
+};
+
+/**
+ * @brief Transport policy for `DFR_RadarTty`: bulk reads straight into the receive buffer
+ *
+ *            struct GatewayTraits : DFR_RadarTraits {
+ *                typedef DFR_RadarPosixTransport Transport;
+ *            };
+ *
+ *            DFR_RadarTty tty;
+ *            tty.begin( "/dev/ttyUSB0" );
+ *            DFR_RadarT<GatewayTraits> sensor( &tty );
+ */
+struct DFR_RadarPosixTransport {
+    typedef DFR_RadarTty Port;
+
+    Port *port = nullptr;
+
+    void attach(Port *p) { port = p; }
+    bool attached() const { return port != nullptr && port->fd() >= 0; }
+
+    int available() const { return port->available(); }
+
+    // Going through `available()` first means an idle wait loop sleeps for `idleWait` each time
+    size_t read(char *buffer, const size_t length) const {
+        return port->available() > 0 ? port->readAvailable(buffer, length) : 0;
+    }
+
+    void write(const char *text) const { port->write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+    void flush() const { port->flush(); }
+};
+
+/**
+ * @brief Watches many sensors' ports from one thread, and hands every complete line each of
+ *        them sends (e.g. pushed `$JYBSS` status) to a callback.
+ *
+ * @details Sensors are configured with `DFR_RadarT` as usual; once they push their output
+ *          (see `setUartOutput()`), add their ports here and call `wait()` in a loop.  A port
+ *          that hangs up (its adapter unplugged, say) is removed, and its hangup callback
+ *          called, so it can be closed and opened again once it's back.
+ *
+ * @note While a port is added, `wait()` consumes everything it receives, so remove it (or
+ *       don't call `wait()`) while talking to that sensor through `DFR_RadarT`.
+ *
+ * @tparam Capacity   Most ports that can be watched at once
+ * @tparam LineLength Longest line delivered, terminator included; longer lines are dropped
+ */
+template<size_t Capacity = 32, size_t LineLength = DFR_RadarTraits::packetLength>
+class DFR_RadarEpoll {
+public:
+    /**
+     * @brief Called for every complete line, without its line terminator; lines end at a <CR>,
+     *        an <LF> or both, and empty ones are skipped
+     *
+     * @param tty     The port the line came from
+     * @param line    The line
+     * @param context Whatever was passed to `add()` for that port
+     */
+    typedef void (*LineCallback)(DFR_RadarTty &tty, const char *line, void *context);
+
+    /**
+     * @brief Called once a port has hung up, after it's been removed; it's still open, so
+     *        `end()` it (and `begin()` it again once the device is back)
+     *
+     * @param tty     The port that hung up
+     * @param context Whatever was passed to `add()` for that port
+     */
+    typedef void (*HangupCallback)(DFR_RadarTty &tty, void *context);
+
+    DFR_RadarEpoll() : descriptor(epoll_create1(EPOLL_CLOEXEC)) {
+        memset(sources, 0, sizeof(sources));
+    }
+
+    ~DFR_RadarEpoll() {
+        if (descriptor >= 0)
+            close(descriptor);
+    }
+
+    DFR_RadarEpoll(const DFR_RadarEpoll &) = delete;
+    DFR_RadarEpoll &operator=(const DFR_RadarEpoll &) = delete;
+
+    /**
+     * @brief Start watching a port
+     *
+     * @param tty      The port
+     * @param callback Called for every line it receives
+     * @param context  Passed to both callbacks
+     * @param hangup   Called if it hangs up
+     *
+     * @return false if it's already watched, all `Capacity` slots are taken, or epoll refused it
+     */
+    bool add(DFR_RadarTty &tty, const LineCallback callback, void *context = nullptr, const HangupCallback hangup = nullptr) {
+        if (descriptor < 0 || tty.fd() < 0 || find(&tty) >= 0)
+            return false;
+
+        const int slot = find(nullptr);
+        if (slot < 0)
+            return false;
+
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u32 = slot;
+
+        if (epoll_ctl(descriptor, EPOLL_CTL_ADD, tty.fd(), &event) != 0)
+            return false;
+
+        Source &source = sources[slot];
+        source.tty = &tty;
+        source.callback = callback;
+        source.hangup = hangup;
+        source.context = context;
+        source.length = 0;
+        source.overflowed = false;
+        return true;
+    }
+
+    /**
+     * @brief Stop watching a port; a partly received line is dropped
+     *
+     * @return false if it wasn't being watched
+     */
+    bool remove(DFR_RadarTty &tty) {
+        const int slot = find(&tty);
+        if (slot < 0)
+            return false;
+
+        epoll_ctl(descriptor, EPOLL_CTL_DEL, tty.fd(), nullptr);
+        sources[slot].tty = nullptr;
+        return true;
+    }
+
+    /**
+     * @brief Wait for any of the ports to receive something, and dispatch every line completed;
+     *        ports that hung up are removed, and their hangup callbacks called
+     *
+     * @param timeout Longest to wait in milliseconds; -1 waits indefinitely, 0 only checks
+     *
+     * @return the number of lines dispatched, or -1 if waiting failed
+     */
+    int wait(const int timeout) {
+        epoll_event events[Capacity];
+        const int ready = epoll_wait(descriptor, events, Capacity, timeout);
+
+        if (ready < 0)
+            return errno == EINTR ? 0 : -1;
+
+        int lines = 0;
+        for (int i = 0; i < ready; i++) {
+            Source &source = sources[events[i].data.u32];
+            if (source.tty == nullptr)
+                continue;
+
+            // Whatever arrived before a hangup is still delivered
+            lines += drain(source);
+
+            if (source.tty != nullptr && ((events[i].events & (EPOLLHUP | EPOLLERR)) || source.tty->isHungUp()))
+                hangUp(source);
+        }
+
+        return lines;
+    }
+
+private:
+    struct Source {
+        DFR_RadarTty *tty;
+        LineCallback callback;
+        HangupCallback hangup;
+        void *context;
+        size_t length;
+        bool overflowed;
+        char line[LineLength];
+    };
+
+    int find(const DFR_RadarTty *tty) const {
+        for (size_t i = 0; i < Capacity; i++) {
+            if (sources[i].tty == tty)
+                return i;
+        }
+
+        return -1;
+    }
+
+    // A hung up port stays readable, so it has to go, or every `wait()` would return at once
+    void hangUp(Source &source) {
+        DFR_RadarTty &tty = *source.tty;
+        const HangupCallback hangup = source.hangup;
+        void *context = source.context;
+
+        remove(tty);
+
+        // Last, as it may add the port again, even into the same slot
+        if (hangup != nullptr)
+            hangup(tty, context);
+    }
+
+    int drain(Source &source) {
+        char chunk[LineLength];
+        int lines = 0;
+        size_t got;
+
+        while ((got = source.tty->readAvailable(chunk, sizeof(chunk))) > 0) {
+            const char *position = chunk;
+            const char *end = chunk + got;
+
+            while (position < end) {
+                // Take everything up to the next <CR> or <LF> in one go, unless the line's too long
+                const char *delimiter = DFR_RadarScan::findEither(position, end - position, '\r', '\n');
+                const size_t run = (delimiter == nullptr ? end : delimiter) - position;
+
+                if (run <= LineLength - 1 - source.length) {
+                    memcpy(source.line + source.length, position, run);
+                    source.length += run;
+                } else
+                    source.overflowed = true;
+
+                if (delimiter == nullptr)
+                    break;
+
+                position = delimiter + 1;
+
+                // Either terminator ends the line, so the <LF> of a <CR><LF> ends an empty one
+                const size_t length = source.length;
+                const bool overflowed = source.overflowed;
+                source.length = 0;
+                source.overflowed = false;
+
+                if (!length || overflowed)
+                    continue;
+
+                source.line[length] = '\0';
+                lines++;
+
+                if (source.callback != nullptr)
+                    source.callback(*source.tty, source.line, source.context);
+
+                // The callback may have removed this port
+                if (source.tty == nullptr)
+                    return lines;
+            }
+        }
+
+        return lines;
+    }
+
+    int descriptor;
+    Source sources[Capacity];
+};
+
+#endif
+
+#endif
@@ -0,0 +1,140 @@
+/**
+  * @file       DFR_RadarScan.cpp
+  * @brief      Finds delimiters (line ends, frame markers) in received data many bytes at a time
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+#include <DFR_RadarScan.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define DFR_RADAR_SCAN_SSE2
+#elif defined(__SIZEOF_POINTER__) && __SIZEOF_POINTER__ == 8 && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define DFR_RADAR_SCAN_SWAR64
+#endif
+
+
+#if defined(DFR_RADAR_SCAN_SSE2)
+
+const char *const DFR_RadarScan::method = "sse2";
+
+const char *DFR_RadarScan::find(const char *data, const size_t length, const char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+
+        if (mask)
+            return data + i + __builtin_ctz(mask);
+    }
+
+    for (; i < length; i++) {
+        if (data[i] == c)
+            return data + i;
+    }
+
+    return nullptr;
+}
+
+const char *DFR_RadarScan::findEither(const char *data, const size_t length, const char a, const char b) {
+    const __m128i first = _mm_set1_epi8(a);
+    const __m128i second = _mm_set1_epi8(b);
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(block, first), _mm_cmpeq_epi8(block, second));
+        const int mask = _mm_movemask_epi8(matches);
+
+        if (mask)
+            return data + i + __builtin_ctz(mask);
+    }
+
+    for (; i < length; i++) {
+        if (data[i] == a || data[i] == b)
+            return data + i;
+    }
+
+    return nullptr;
+}
+
+#elif defined(DFR_RADAR_SCAN_SWAR64)
+
+const char *const DFR_RadarScan::method = "swar64";
+
+static constexpr uint64_t lowBits = 0x0101010101010101ULL;
+static constexpr uint64_t highBits = 0x8080808080808080ULL;
+
+// The high bit of every zero byte in `word` is set; bytes after the first zero may be flagged
+// too (the borrow ripples up), but never one before it, so the lowest flag is always right
+static inline uint64_t zeroBytes(const uint64_t word) {
+    return (word - lowBits) & ~word & highBits;
+}
+
+static inline uint64_t load(const char *data) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+const char *DFR_RadarScan::find(const char *data, const size_t length, const char c) {
+    const uint64_t needle = lowBits * static_cast<uint8_t>(c);
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const uint64_t matches = zeroBytes(load(data + i) ^ needle);
+
+        if (matches)
+            return data + i + __builtin_ctzll(matches) / 8;
+    }
+
+    for (; i < length; i++) {
+        if (data[i] == c)
+            return data + i;
+    }
+
+    return nullptr;
+}
+
+const char *DFR_RadarScan::findEither(const char *data, const size_t length, const char a, const char b) {
+    const uint64_t first = lowBits * static_cast<uint8_t>(a);
+    const uint64_t second = lowBits * static_cast<uint8_t>(b);
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const uint64_t word = load(data + i);
+        const uint64_t matches = zeroBytes(word ^ first) | zeroBytes(word ^ second);
+
+        if (matches)
+            return data + i + __builtin_ctzll(matches) / 8;
+    }
+
+    for (; i < length; i++) {
+        if (data[i] == a || data[i] == b)
+            return data + i;
+    }
+
+    return nullptr;
+}
+
+#else
+
+const char *const DFR_RadarScan::method = "scalar";
+
+const char *DFR_RadarScan::find(const char *data, const size_t length, const char c) {
+    return static_cast<const char *>(memchr(data, c, length));
+}
+
+const char *DFR_RadarScan::findEither(const char *data, const size_t length, const char a, const char b) {
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] == a || data[i] == b)
+            return data + i;
+    }
+
+    return nullptr;
+}
+
+#endif
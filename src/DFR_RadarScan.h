@@ -0,0 +1,44 @@
+/**
+  * @file       DFR_RadarScan.h
+  * @brief      Finds delimiters (line ends, frame markers) in received data many bytes at a time
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarScan_H_
+#define DFR_RadarScan_H_
+
+#include <Arduino.h>
+
+
+/**
+ * @brief Delimiter search over a block of received bytes.
+ *
+ * @details Host builds compare 16 bytes per instruction with SSE2, or 8 per step on other
+ *          64-bit little-endian CPUs (SWAR: bit tricks on a whole word).  On microcontrollers
+ *          this is the C library's `memchr()` for one delimiter and a plain loop for two, which
+ *          is as fast as it gets for the short lines the sensor sends.
+ */
+struct DFR_RadarScan {
+    /**
+     * @brief Name of the implementation that was compiled in: "sse2", "swar64" or "scalar"
+     */
+    static const char *const method;
+
+    /**
+     * @brief Find the first occurrence of a byte
+     *
+     * @return a pointer to it, or nullptr if it isn't in the first `length` bytes of `data`
+     */
+    static const char *find(const char *data, size_t length, char c);
+
+    /**
+     * @brief Find the first occurrence of either of two bytes, e.g. '\r' or '\n'
+     *
+     * @return a pointer to it, or nullptr if neither is in the first `length` bytes of `data`
+     */
+    static const char *findEither(const char *data, size_t length, char a, char b);
+};
+
+#endif
@@ -0,0 +1,230 @@
+/**
+  * @file       DFR_RadarScheduler.h
+  * @brief      Interleaves queued configuration changes with presence reads, so reconfiguring never blinds the application
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarScheduler_H_
+#define DFR_RadarScheduler_H_
+
+#include <Arduino.h>
+#include <DFR_RadarCommands.h>
+
+
+/**
+ * @brief Runs one sensor's work in two priority classes: presence reads and health recovery
+ *        first, queued configuration commands only when those aren't due.
+ *
+ * @details Call `run()` from `loop()`; each call does at most one thing.  A configuration
+ *          command is a whole cycle on its own (stop, send, start), so the sensor keeps
+ *          detecting between commands and a presence read can get in after each one.  The
+ *          presence reading is therefore never older than the presence interval plus one
+ *          command cycle, however much configuration is queued.
+ *
+ *          Enable write-back on the sensor (`setWriteBack(true)`) so a batch of commands is
+ *          saved to flash once: the scheduler commits as soon as the queue is empty.
+ *
+ * @tparam Radar The sensor's driver (e.g. `DFR_Radar`)
+ * @tparam Depth Most configuration commands that can be queued
+ */
+template<typename Radar, uint8_t Depth = 8>
+class DFR_RadarScheduler {
+public:
+    /**
+     * @brief What a call to `run()` did
+     */
+    enum Work : uint8_t {
+        Idle,       // Nothing was due
+        Presence,   // Read presence
+        Config,     // Sent a queued configuration command
+        Commit      // Saved the finished batch to flash
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * @param radar            The sensor to schedule
+     * @param presenceInterval Time in milliseconds between presence reads
+     */
+    explicit DFR_RadarScheduler(Radar &radar, const unsigned long presenceInterval = 250)
+        : radar(radar), presenceInterval(presenceInterval), head(0), count(0), pendingCommit(false),
+          presence(false), sampled(false), lastPresence(0),
+          maxCount(0), completed(0), failed(0), totalWait(0), maxWait(0), maxPresenceAge(0) {}
+
+    /**
+     * @brief Change the time between presence reads
+     *
+     * @param presenceInterval Time in milliseconds
+     */
+    void setPresenceInterval(const unsigned long presenceInterval) { this->presenceInterval = presenceInterval; }
+
+    /**
+     * @brief Queue a configuration command, to be sent when no presence read is due
+     *
+     * @param command   Any setter in `DFR_RadarCommands`
+     * @param arguments One value per argument of the command; checked when it's sent
+     *
+     * @return false if the queue is full or `command` isn't a setter
+     */
+    bool schedule(const DFR_RadarCommand &command, const float arguments[]) {
+        if (count == Depth || command.fieldCount)
+            return false;
+
+        Job &job = jobs[(head + count) % Depth];
+        job.values.command = &command;
+
+        for (uint8_t i = 0; i < command.argumentCount; i++)
+            job.values.arguments[i] = arguments[i];
+
+        job.queued = millis();
+
+        if (++count > maxCount)
+            maxCount = count;
+
+        return true;
+    }
+
+    /**
+     * @brief Do the most urgent piece of work that's due: health recovery (through the sensor's
+     *        own `update()`), then a presence read, then one queued command, then saving a
+     *        finished batch
+     *
+     * @return what was done
+     */
+    Work run(void) {
+        radar.update();
+
+        const unsigned long now = millis();
+
+        if (!sampled || now - lastPresence >= presenceInterval) {
+            if (sampled && now - lastPresence > maxPresenceAge)
+                maxPresenceAge = now - lastPresence;
+
+            bool reading = false;
+            if (radar.readPresence(reading))
+                presence = reading;
+
+            // Failed or not, don't try again until the next interval, so the queue still moves
+            sampled = true;
+            lastPresence = millis();
+            return Presence;
+        }
+
+        if (count) {
+            Job &job = jobs[head];
+            const unsigned long waited = now - job.queued;
+
+            totalWait += waited;
+            if (waited > maxWait)
+                maxWait = waited;
+
+            if (radar.set(*job.values.command, job.values.arguments))
+                completed++;
+            else
+                failed++;
+
+            head = (head + 1) % Depth;
+            count--;
+            pendingCommit = true;
+            return Config;
+        }
+
+        if (pendingCommit) {
+            radar.commit();
+            pendingCommit = false;
+            return Commit;
+        }
+
+        return Idle;
+    }
+
+    /**
+     * @brief Get the last presence state that was read
+     */
+    bool getPresence(void) const { return presence; }
+
+    /**
+     * @brief Get how long ago presence was last read
+     *
+     * @return time in milliseconds
+     */
+    unsigned long getPresenceAge(void) const { return millis() - lastPresence; }
+
+    /**
+     * @brief Get the longest presence has gone without a read while it was due
+     *
+     * @return time in milliseconds
+     */
+    unsigned long getMaxPresenceAge(void) const { return maxPresenceAge; }
+
+    /**
+     * @brief Check if there's configuration work left (queued or not yet saved)
+     */
+    bool isBusy(void) const { return count || pendingCommit; }
+
+    /**
+     * @brief Get the number of commands waiting in the queue
+     */
+    uint8_t getQueueDepth(void) const { return count; }
+
+    /**
+     * @brief Get the most commands that have been waiting in the queue at once
+     */
+    uint8_t getMaxQueueDepth(void) const { return maxCount; }
+
+    /**
+     * @brief Get the number of queued commands the sensor accepted
+     */
+    uint32_t getCompletedCount(void) const { return completed; }
+
+    /**
+     * @brief Get the number of queued commands that failed (invalid values, or the sensor refused)
+     */
+    uint32_t getFailedCount(void) const { return failed; }
+
+    /**
+     * @brief Get the average time commands waited in the queue before being sent
+     *
+     * @return time in milliseconds (0 if none has been sent yet)
+     */
+    unsigned long getAverageWait(void) const {
+        const uint32_t sent = completed + failed;
+        return sent ? totalWait / sent : 0;
+    }
+
+    /**
+     * @brief Get the longest time a command waited in the queue before being sent
+     *
+     * @return time in milliseconds
+     */
+    unsigned long getMaxWait(void) const { return maxWait; }
+
+private:
+    struct Job {
+        DFR_RadarCommandValues values;
+        unsigned long queued;
+    };
+
+    Radar &radar;
+    unsigned long presenceInterval;
+
+    Job jobs[Depth];
+    uint8_t head;
+    uint8_t count;
+    bool pendingCommit;
+
+    bool presence;
+    bool sampled;
+    unsigned long lastPresence;
+
+    uint8_t maxCount;
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t totalWait;
+    unsigned long maxWait;
+    unsigned long maxPresenceAge;
+};
+
+#endif
@@ -0,0 +1,418 @@
+/**
+  * @file       DFR_RadarShared.h
+  * @brief      Publishes each sensor's latest state in shared memory, for any number of reader processes on a Linux gateway
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  *
+  * @note Only for Linux builds outside of Arduino, like `DFR_RadarPosix.h`.
+  */
+
+
+#ifndef DFR_RadarShared_H_
+#define DFR_RadarShared_H_
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <Arduino.h>
+#include <DFR_RadarPoint.h>
+#include <atomic>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/**
+ * @brief One sensor's latest state, as published
+ */
+struct DFR_RadarSharedState {
+    static constexpr uint8_t maxPoints = 32;
+
+    uint64_t updated;       // `millis()` (CLOCK_MONOTONIC, so comparable across processes) when last published
+    uint32_t updates;       // Times published
+    uint8_t presence;       // 1 if presence is detected
+    uint8_t health;         // A `DFR_RadarT::HealthState`
+    uint8_t pointCount;     // Points in the last point cloud frame
+    uint8_t reserved;
+    DFR_RadarPoint points[maxPoints];
+};
+
+/**
+ * @brief The layout of the shared segment, shared by the publisher and the readers
+ *
+ * @details A header, then one slot per sensor.  Each slot is a seqlock: a sequence number
+ *          that's odd while the publisher is writing the slot, then the state, as 32-bit words.
+ *
+ *              header:  magic  version  sensors  slot words
+ *              slot:    sequence  state words
+ *
+ *          The publisher makes the sequence odd, writes the words and makes it even again; it
+ *          never waits for anyone.  A reader copies the words between two reads of the
+ *          sequence, and starts over if the sequence was odd or changed in between.  All of
+ *          it is atomic loads and stores of aligned 32-bit words, which are lock-free
+ *          everywhere Linux runs, so readers can map the segment read-only.
+ */
+struct DFR_RadarSharedFormat {
+    static constexpr uint32_t magic = 'D' | 'R' << 8 | 'S' << 16 | 'M' << 24;
+    static constexpr uint32_t version = 1;
+
+    static constexpr size_t stateWords = (sizeof(DFR_RadarSharedState) + 3) / 4;
+
+    struct Header {
+        std::atomic<uint32_t> magic;    // Stored last, so a reader never sees a half-made header
+        uint32_t version;
+        std::atomic<uint32_t> sensors;  // Checked by readers on every read, in case it was re-made
+        uint32_t slotWords;
+    };
+
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        std::atomic<uint32_t> words[stateWords];
+    };
+
+    static size_t segmentSize(const uint16_t sensors) { return sizeof(Header) + sensors * sizeof(Slot); }
+
+    static Slot *slots(void *segment) {
+        return reinterpret_cast<Slot *>(static_cast<uint8_t *>(segment) + sizeof(Header));
+    }
+};
+
+/**
+ * @brief Publishes the latest state of up to 65535 sensors, e.g. from a gateway's event loop
+ *
+ *            DFR_RadarSharedPublisher publisher;
+ *            publisher.begin( "/dfr_radar", sensorCount );
+ *
+ *            publisher.publishPresence( 0, status.presence );
+ *            publisher.publishFrame( 0, cloud.getPoints(), cloud.getCount() );
+ *
+ * @details Publishing copies the state into the segment and never blocks, whatever the readers
+ *          do.  There must be only one publisher per segment (calls from several threads must
+ *          take turns).  The segment outlives the publisher until `end( true )` or a reboot.
+ */
+class DFR_RadarSharedPublisher {
+public:
+    DFR_RadarSharedPublisher() : segment(nullptr), size(0), sensors(0), name(nullptr) {}
+    ~DFR_RadarSharedPublisher() { end(); }
+
+    DFR_RadarSharedPublisher(const DFR_RadarSharedPublisher &) = delete;
+    DFR_RadarSharedPublisher &operator=(const DFR_RadarSharedPublisher &) = delete;
+
+    /**
+     * @brief Create (or take over) a shared segment, with every sensor's state cleared
+     *
+     * @details Taking over a segment never shrinks it, as readers may still have all of it
+     *          mapped; they find out from `read()` failing if it now holds fewer sensors.
+     *
+     * @param name    The segment's name, starting with '/' (e.g. "/dfr_radar"); kept, not copied
+     * @param sensors How many sensors it holds
+     *
+     * @return false if it couldn't be created or mapped (see `errno`)
+     */
+    bool begin(const char *name, const uint16_t sensors) {
+        end();
+
+        const int fd = shm_open(name, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return false;
+
+        // Touching a page past the end of the file is SIGBUS, so only ever grow it
+        const size_t length = DFR_RadarSharedFormat::segmentSize(sensors);
+        struct stat info;
+        const bool sized = fstat(fd, &info) == 0 &&
+                           (static_cast<size_t>(info.st_size) >= length || ftruncate(fd, length) == 0);
+
+        void *mapped = sized ? mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+
+        if (mapped == MAP_FAILED)
+            return false;
+
+        segment = mapped;
+        size = length;
+        this->sensors = sensors;
+        this->name = name;
+
+        DFR_RadarSharedFormat::Header *header = static_cast<DFR_RadarSharedFormat::Header *>(segment);
+
+        // Until the magic is back, readers' `read()` fails instead of copying half-cleared slots
+        header->magic.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        header->version = DFR_RadarSharedFormat::version;
+        header->sensors.store(sensors, std::memory_order_relaxed);
+        header->slotWords = DFR_RadarSharedFormat::stateWords;
+
+        DFR_RadarSharedState cleared;
+        memset(&cleared, 0, sizeof(cleared));
+
+        DFR_RadarSharedFormat::Slot *slots = DFR_RadarSharedFormat::slots(segment);
+        for (uint16_t i = 0; i < sensors; i++) {
+            // A publisher that died mid-write left its slot odd, which would turn every publish
+            // inside out; round it up, so it's even again and still past what readers have seen
+            const uint32_t sequence = slots[i].sequence.load(std::memory_order_relaxed);
+            slots[i].sequence.store((sequence + 1) & ~1u, std::memory_order_relaxed);
+
+            publish(i, cleared);
+        }
+
+        header->magic.store(DFR_RadarSharedFormat::magic, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Unmap the segment
+     *
+     * @param remove Also remove it, so readers that open it later fail (those that have it
+     *               mapped keep the last state)
+     */
+    void end(const bool remove = false) {
+        if (segment == nullptr)
+            return;
+
+        munmap(segment, size);
+        if (remove)
+            shm_unlink(name);
+
+        segment = nullptr;
+    }
+
+    /**
+     * @brief Publish a sensor's whole state; `updated` and `updates` are filled in
+     *
+     * @return false if there's no such sensor
+     */
+    bool publish(const uint16_t sensor, const DFR_RadarSharedState &state) {
+        if (segment == nullptr || sensor >= sensors)
+            return false;
+
+        DFR_RadarSharedState published = state;
+        published.updated = millis();
+        published.updates = current(sensor).updates + 1;
+
+        uint32_t words[DFR_RadarSharedFormat::stateWords] = { 0 };
+        memcpy(words, &published, sizeof(published));
+
+        DFR_RadarSharedFormat::Slot &slot = DFR_RadarSharedFormat::slots(segment)[sensor];
+        const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+
+        // Odd: readers that get this far start over
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < DFR_RadarSharedFormat::stateWords; i++)
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Publish a change in a sensor's presence, keeping the rest of its state
+     */
+    bool publishPresence(const uint16_t sensor, const bool presence) {
+        if (segment == nullptr || sensor >= sensors)
+            return false;
+
+        DFR_RadarSharedState state = current(sensor);
+        state.presence = presence;
+        return publish(sensor, state);
+    }
+
+    /**
+     * @brief Publish a change in a sensor's health (e.g. from its health callback), keeping the rest of its state
+     */
+    bool publishHealth(const uint16_t sensor, const uint8_t health) {
+        if (segment == nullptr || sensor >= sensors)
+            return false;
+
+        DFR_RadarSharedState state = current(sensor);
+        state.health = health;
+        return publish(sensor, state);
+    }
+
+    /**
+     * @brief Publish a sensor's latest point cloud frame, keeping the rest of its state
+     *
+     * @param points The frame's points; past `DFR_RadarSharedState::maxPoints`, the rest are left out
+     * @param count  How many
+     */
+    bool publishFrame(const uint16_t sensor, const DFR_RadarPoint points[], uint8_t count) {
+        if (segment == nullptr || sensor >= sensors)
+            return false;
+
+        if (count > DFR_RadarSharedState::maxPoints)
+            count = DFR_RadarSharedState::maxPoints;
+
+        DFR_RadarSharedState state = current(sensor);
+        memcpy(state.points, points, count * sizeof(DFR_RadarPoint));
+        state.pointCount = count;
+        return publish(sensor, state);
+    }
+
+private:
+    // The only writer can read its own slots without the protocol
+    DFR_RadarSharedState current(const uint16_t sensor) const {
+        const DFR_RadarSharedFormat::Slot &slot = DFR_RadarSharedFormat::slots(segment)[sensor];
+
+        uint32_t words[DFR_RadarSharedFormat::stateWords];
+        for (size_t i = 0; i < DFR_RadarSharedFormat::stateWords; i++)
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+
+        DFR_RadarSharedState state;
+        memcpy(&state, words, sizeof(state));
+        return state;
+    }
+
+    void *segment;
+    size_t size;
+    uint16_t sensors;
+    const char *name;
+};
+
+/**
+ * @brief Reads the states a `DFR_RadarSharedPublisher` publishes, from any process
+ *
+ *            DFR_RadarSharedReader reader;
+ *            reader.begin( "/dfr_radar" );
+ *
+ *            DFR_RadarSharedState state;
+ *            if( reader.read( 0, state ) && state.presence )
+ *              ...
+ *
+ * @details Once the segment is mapped, reading is a few dozen memory loads: no system calls,
+ *          no locks, and nothing a reader does can hold up the publisher.  A reader that races
+ *          the publisher simply copies again; `read()` gives up after a few tries (which takes
+ *          a publisher writing the same slot continuously, or one that died mid-write until
+ *          another takes the segment over).
+ */
+class DFR_RadarSharedReader {
+public:
+    /**
+     * @brief Copies before `read()` gives up
+     */
+    static constexpr uint8_t maxAttempts = 16;
+
+    DFR_RadarSharedReader() : segment(nullptr), size(0), sensors(0) {}
+    ~DFR_RadarSharedReader() { end(); }
+
+    DFR_RadarSharedReader(const DFR_RadarSharedReader &) = delete;
+    DFR_RadarSharedReader &operator=(const DFR_RadarSharedReader &) = delete;
+
+    /**
+     * @brief Map a publisher's segment, read-only
+     *
+     * @param name The name it was created with
+     *
+     * @return false if it doesn't exist, isn't ready yet, or has a layout this reader doesn't know
+     */
+    bool begin(const char *name) {
+        end();
+
+        const int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        void *mapped = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(DFR_RadarSharedFormat::Header))
+            mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (mapped == MAP_FAILED)
+            return false;
+
+        const DFR_RadarSharedFormat::Header *header = static_cast<const DFR_RadarSharedFormat::Header *>(mapped);
+        const bool valid = header->magic.load(std::memory_order_acquire) == DFR_RadarSharedFormat::magic &&
+                           header->version == DFR_RadarSharedFormat::version &&
+                           header->slotWords == DFR_RadarSharedFormat::stateWords &&
+                           DFR_RadarSharedFormat::segmentSize(header->sensors.load(std::memory_order_relaxed)) <= static_cast<size_t>(info.st_size);
+
+        if (!valid) {
+            munmap(mapped, info.st_size);
+            return false;
+        }
+
+        segment = mapped;
+        size = info.st_size;
+        sensors = header->sensors.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Unmap the segment
+     */
+    void end(void) {
+        if (segment == nullptr)
+            return;
+
+        munmap(segment, size);
+        segment = nullptr;
+        sensors = 0;
+    }
+
+    /**
+     * @brief Get the number of sensors in the segment
+     */
+    uint16_t getSensorCount(void) const { return sensors; }
+
+    /**
+     * @brief Copy a consistent snapshot of a sensor's state
+     *
+     * @return false if there's no such sensor, the segment is being made again by a publisher
+     *         (or was, for a different number of sensors; `begin()` again), or there was no
+     *         consistent copy after `maxAttempts` tries
+     */
+    bool read(const uint16_t sensor, DFR_RadarSharedState &state) const {
+        if (segment == nullptr || sensor >= sensors)
+            return false;
+
+        const DFR_RadarSharedFormat::Header *header = static_cast<const DFR_RadarSharedFormat::Header *>(segment);
+        if (header->magic.load(std::memory_order_acquire) != DFR_RadarSharedFormat::magic ||
+            header->sensors.load(std::memory_order_relaxed) != sensors)
+            return false;
+
+        const DFR_RadarSharedFormat::Slot &slot = DFR_RadarSharedFormat::slots(segment)[sensor];
+        uint32_t words[DFR_RadarSharedFormat::stateWords];
+
+        for (uint8_t attempt = 0; attempt < maxAttempts; attempt++) {
+            const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1)
+                continue;
+
+            for (size_t i = 0; i < DFR_RadarSharedFormat::stateWords; i++)
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != before)
+                continue;
+
+            memcpy(&state, words, sizeof(state));
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Get how many times a sensor's state has been published, without copying it, e.g.
+     *        to poll for changes cheaply
+     *
+     * @return the count, which only changes when the state does (0 if there's no such sensor)
+     */
+    uint32_t getVersion(const uint16_t sensor) const {
+        if (segment == nullptr || sensor >= sensors)
+            return 0;
+
+        return DFR_RadarSharedFormat::slots(segment)[sensor].sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    void *segment;
+    size_t size;
+    uint16_t sensors;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+/**
+  * @file       DFR_RadarStatus.cpp
+  * @brief      The sensor's detection status ($JYBSS) and a validating parser for it
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+#include <DFR_RadarStatus.h>
+#include <DFR_RadarScan.h>
+
+
+bool DFR_RadarStatus::parse(const char *line, const size_t length, DFR_RadarStatus &status) {
+    static const char tag[] = "JYBSS";
+    static constexpr size_t tagLength = sizeof(tag) - 1;
+
+    const char *start = DFR_RadarScan::find(line, length, '$');
+    if (start == nullptr)
+        return false;
+
+    start++;
+    const char *end = DFR_RadarScan::find(start, line + length - start, '*');
+    if (end == nullptr)
+        return false;
+
+    // The tag comes first, followed by a comma
+    if (end - start <= static_cast<ptrdiff_t>(tagLength) || memcmp(start, tag, tagLength) != 0 || start[tagLength] != ',')
+        return false;
+
+    const char *field = start + tagLength + 1;
+    uint8_t index = 0;
+
+    while (true) {
+        const char *comma = DFR_RadarScan::find(field, end - field, ',');
+        const char *fieldEnd = comma == nullptr ? end : comma;
+
+        // Too many fields
+        if (index > reservedFields)
+            return false;
+
+        // Trim the padding
+        const char *first = field;
+        const char *last = fieldEnd;
+
+        while (first < last && *first == ' ')
+            first++;
+
+        while (last > first && last[-1] == ' ')
+            last--;
+
+        for (const char *c = first; c < last; c++) {
+            if (*c < ' ' || *c > '~' || *c == '$')
+                return false;
+        }
+
+        const size_t width = last - first;
+
+        if (index == 0) {
+            if (width != 1 || (*first != '0' && *first != '1'))
+                return false;
+
+            status.presence = *first == '1';
+        } else {
+            if (width >= reservedLength)
+                return false;
+
+            memcpy(status.reserved[index - 1], first, width);
+            status.reserved[index - 1][width] = '\0';
+        }
+
+        index++;
+
+        if (comma == nullptr)
+            break;
+
+        field = comma + 1;
+    }
+
+    // Too few fields
+    return index == reservedFields + 1;
+}
@@ -0,0 +1,68 @@
+/**
+  * @file       DFR_RadarStatus.h
+  * @brief      The sensor's detection status ($JYBSS) and a validating parser for it
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarStatus_H_
+#define DFR_RadarStatus_H_
+
+#include <Arduino.h>
+#include <DFR_RadarLatency.h>
+
+
+/**
+ * @brief One detection status frame from the sensor, e.g. `$JYBSS,1, , , *`
+ *
+ * @details The frame is a tag and four comma-separated fields between `$` and `*`: the
+ *          presence flag, then three fields the sensor currently leaves blank.  Those are kept
+ *          as text (trimmed), so a firmware that fills them in is still readable.
+ */
+struct DFR_RadarStatus {
+    static constexpr uint8_t reservedFields = 3;
+    static constexpr uint8_t reservedLength = 8;
+
+    /**
+     * @brief Whether the sensor detects presence
+     */
+    bool presence;
+
+    /**
+     * @brief The remaining fields, without surrounding spaces; normally empty
+     */
+    char reserved[reservedFields][reservedLength];
+
+    /**
+     * @brief `millis()` when the frame was received
+     */
+    unsigned long timestamp;
+
+    /**
+     * @brief Counts up by one for every valid frame the driver receives, so a gap means frames were missed or rejected
+     */
+    uint32_t sequence;
+
+    /**
+     * @brief When the frame was requested, received and decoded, in `micros()`
+     */
+    DFR_RadarTiming timing;
+
+    /**
+     * @brief Parse a frame in place, wherever it is in `line` (e.g. after a prompt)
+     *
+     * @details The frame must have the `JYBSS` tag, exactly four fields, a presence flag of `0`
+     *          or `1`, and nothing but printable characters in the other fields, each short
+     *          enough to keep.  Fills in `presence` and `reserved` only.
+     *
+     * @param line   The text received
+     * @param length Its length
+     * @param status Where to put the fields
+     *
+     * @return false if there's no complete, valid frame in `line` (`status` may be partly filled in)
+     */
+    static bool parse(const char *line, size_t length, DFR_RadarStatus &status);
+};
+
+#endif
@@ -0,0 +1,21 @@
+/**
+  * @file       DFR_RadarTraits.cpp
+  * @brief      Compile-time policies that select which parts of DFR_Radar get built, and how big they are
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+#include <DFR_RadarTraits.h>
+#include <stdarg.h>
+
+
+void DFR_RadarSerialLog::printf(const char *format, ...) {
+    char buffer[bufferLength];
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    Serial.print(buffer);
+}
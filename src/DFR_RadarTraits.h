@@ -0,0 +1,188 @@
+/**
+  * @file       DFR_RadarTraits.h
+  * @brief      Compile-time policies that select which parts of DFR_Radar get built, and how big they are
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarTraits_H_
+#define DFR_RadarTraits_H_
+
+#include <Arduino.h>
+#include <DFR_RadarTransport.h>
+
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
+
+/**
+ * @brief Logging policy that prints debug output to `Serial` (only when `setDebug(true)` was called)
+ *
+ * @note Formats into a small stack buffer and prints that, so it works on cores whose `Print`
+ *       has no `printf()` (AVR, megaAVR).
+ */
+struct DFR_RadarSerialLog {
+    static constexpr bool enabled = true;
+    static constexpr size_t bufferLength = 80;
+
+    static void printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+};
+
+/**
+ * @brief Logging policy that compiles all debug output away, including its format strings
+ */
+struct DFR_RadarNoLog {
+    static constexpr bool enabled = false;
+
+    static void printf(const char *, ...) {}
+};
+
+/**
+ * @brief Idle policy that keeps polling the port at full speed while waiting on the sensor
+ */
+struct DFR_RadarBusyIdle {
+    static void wait() {}
+};
+
+/**
+ * @brief Idle policy that calls `yield()` while waiting on the sensor, so other tasks (or the
+ *        ESP8266/ESP32 Wi-Fi stack) get to run
+ */
+struct DFR_RadarYieldIdle {
+    static void wait() { yield(); }
+};
+
+/**
+ * @brief Idle policy that sleeps the core while waiting on the sensor, until the next interrupt:
+ *        a byte from the UART, a pin change, or the timer behind `millis()` (so timeouts still
+ *        expire on time).
+ *
+ * @details AVR and megaAVR use idle sleep, which keeps the UART and timers running; ARM cores
+ *          wait for an interrupt; ESP32 and ESP8266 give the rest of the tick to the RTOS, whose
+ *          idle task can light-sleep if power management is enabled.  Anything else just yields.
+ */
+struct DFR_RadarSleepIdle {
+    static void wait() {
+#if defined(__AVR__)
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        sleep_mode();
+#elif defined(ESP32) || defined(ESP8266)
+        delay(1);
+#elif defined(__arm__)
+        __asm__ volatile("wfi");
+#else
+        yield();
+#endif
+    }
+};
+
+/**
+ * @brief Storage for `Count` items; the `Count == 0` case takes no RAM at all
+ */
+template<typename T, size_t Count>
+struct DFR_RadarArray {
+    T items[Count];
+
+    T *at(const size_t i) { return items + i; }
+    const T *at(const size_t i) const { return items + i; }
+    void clear() { memset(items, 0, sizeof(items)); }
+};
+
+template<typename T>
+struct DFR_RadarArray<T, 0> {
+    T *at(size_t) { return nullptr; }
+    const T *at(size_t) const { return nullptr; }
+    void clear() {}
+};
+
+/**
+ * @brief The default policy: every feature enabled, sized for any board.
+ *
+ * @details To trim DFR_Radar down, derive from this, override what you don't need and use
+ *          `DFR_RadarT<YourTraits>` instead of `DFR_Radar`:
+ *
+ *              struct PresenceOnly : DFR_RadarTraits {
+ *                  static constexpr uint8_t pipelineDepth = 0;
+ *                  static constexpr uint8_t configCacheSlots = 0;
+ *                  typedef DFR_RadarNoLog Log;
+ *              };
+ *
+ *              DFR_RadarT<PresenceOnly> sensor( &Serial1 );
+ *
+ *          Only the methods a sketch actually calls are compiled for a custom policy, so the
+ *          getters, UART output and version methods cost nothing unless they're used.
+ */
+struct DFR_RadarTraits {
+    /**
+     * @brief Size of the buffers used to receive a line (or a presence packet) from the sensor;
+     *        must fit `DFR_RadarCommands::longestResponse` if any getters are used
+     */
+    static constexpr size_t packetLength = 64;
+
+    /**
+     * @brief Size of the receive buffer; bytes are read from the port in chunks of up to this many
+     *        and lines are split out of it, instead of reading the port a byte at a time
+     */
+    static constexpr uint8_t receiveLength = 32;
+
+    /**
+     * @brief How many configuration commands can be queued and pipelined in multi-config mode;
+     *        0 removes the queue and `setPipelineDepth()` will refuse anything above 0
+     */
+    static constexpr uint8_t pipelineDepth = 4;
+
+    /**
+     * @brief How many settings are remembered for re-applying during health recovery;
+     *        0 removes the cache, so recovery only reboots the sensor
+     */
+    static constexpr uint8_t configCacheSlots = 8;
+
+    /**
+     * @brief Whether to track the sensor's health, fail fast and recover it (see `setHealthThreshold()`)
+     */
+    static constexpr bool healthMonitor = true;
+
+    /**
+     * @brief Whether saving the configuration can be deferred (see `setWriteBack()`); if false,
+     *        every change is saved straight away
+     */
+    static constexpr bool writeBack = true;
+
+    /**
+     * @brief Whether received bytes can be mirrored to another port (see `setTap()`)
+     */
+    static constexpr bool tap = true;
+
+    /**
+     * @brief Whether fractional values are sent to the sensor with decimals; if false, they're
+     *        truncated to whole numbers, which drops the decimal formatting code
+     */
+    static constexpr bool floatSupport = true;
+
+    /**
+     * @brief Whether received frames are stamped with `micros()` (see `DFR_RadarTiming`); if false,
+     *        their timing is all 0 and nothing is stamped
+     */
+    static constexpr bool timestamps = true;
+
+    /**
+     * @brief Where debug output goes; `DFR_RadarNoLog` compiles it out
+     */
+    typedef DFR_RadarSerialLog Log;
+
+    /**
+     * @brief What to do while waiting on the sensor; `DFR_RadarSleepIdle` sleeps the core until the
+     *        next interrupt instead, or supply your own with a `static void wait()`
+     */
+    typedef DFR_RadarYieldIdle Idle;
+
+    /**
+     * @brief How bytes get to and from the sensor; `DFR_RadarPortTransport` binds the calls to one
+     *        port class at compile time, instead of going through `Stream`'s virtual methods
+     */
+    typedef DFR_RadarStreamTransport Transport;
+};
+
+#endif
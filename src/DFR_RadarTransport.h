@@ -0,0 +1,178 @@
+/**
+  * @file       DFR_RadarTransport.h
+  * @brief      Transport policies: how DFR_Radar moves bytes to and from the sensor's UART
+  * @license    The MIT License (MIT)
+  * @url        https://github.com/timtimmahh/DFR_Radar
+  */
+
+
+#ifndef DFR_RadarTransport_H_
+#define DFR_RadarTransport_H_
+
+#include <Arduino.h>
+
+
+/**
+ * @brief Transport policy for any `Stream`; every call goes through its virtual methods.
+ *
+ * @details This is the default, so `DFR_Radar` keeps accepting a `Stream *` (hardware or
+ *          software serial, or anything else that reads and writes bytes).
+ *
+ * @note A transport only needs what's here: a `Port` type, `attach()`/`attached()`, a
+ *       non-blocking `available()` and bulk `read()`, and `write()`/`flush()`.
+ */
+struct DFR_RadarStreamTransport {
+    typedef Stream Port;
+
+    Port *port = nullptr;
+
+    void attach(Port *p) { port = p; }
+    bool attached() const { return port != nullptr; }
+
+    int available() const { return port->available(); }
+
+    /**
+     * @brief Read whatever has already arrived, up to `length` bytes, without waiting
+     *
+     * @note Read a byte at a time: `Stream::readBytes()` isn't virtual, so through a `Stream *`
+     *       it's always the generic one, which costs a `timedRead()` (the same virtual `read()`,
+     *       plus `millis()`) per byte.  Use `DFR_RadarPortTransport` to get a port's own bulk
+     *       read.
+     *
+     * @return the number of bytes read
+     */
+    size_t read(char *buffer, const size_t length) const {
+        const int ready = port->available();
+        if (ready <= 0)
+            return 0;
+
+        const size_t count = static_cast<size_t>(ready) < length ? ready : length;
+
+        for (size_t i = 0; i < count; i++)
+            buffer[i] = port->read();
+
+        return count;
+    }
+
+    void write(const char *text) const { port->write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+    void flush() const { port->flush(); }
+};
+
+/**
+ * @brief Transport policy for one concrete port class, e.g. `HardwareSerial`, `SoftwareSerial`
+ *        or `DFR_RadarMemoryPort`.
+ *
+ * @details Calls are qualified with `Port`, so they bind at compile time instead of going
+ *          through the vtable, and can be inlined where the port's methods are visible.  If the
+ *          port has a bulk `read(char *, size_t)` (ESP32 and ESP8266 `HardwareSerial` do), what
+ *          has arrived is copied out with one call to it instead of a `read()` per byte:
+ *
+ *              struct Serial1Traits : DFR_RadarTraits {
+ *                  typedef DFR_RadarPortTransport<decltype(Serial1)> Transport;
+ *              };
+ *
+ *              DFR_RadarT<Serial1Traits> sensor( &Serial1 );
+ *
+ * @tparam P The port's own class (not a base class like `Stream`)
+ */
+template<typename P>
+struct DFR_RadarPortTransport {
+    typedef P Port;
+
+    Port *port = nullptr;
+
+    void attach(Port *p) { port = p; }
+    bool attached() const { return port != nullptr; }
+
+    int available() const { return port->Port::available(); }
+
+    size_t read(char *buffer, const size_t length) const {
+        const int ready = port->Port::available();
+        if (ready <= 0)
+            return 0;
+
+        const size_t count = static_cast<size_t>(ready) < length ? ready : length;
+        return readFrom(port, buffer, count, 0);
+    }
+
+    void write(const char *text) const { port->Port::write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+    void flush() const { port->Port::flush(); }
+
+private:
+    // Picked when the port has a bulk read; the `int` parameter makes it the better match
+    template<typename Q>
+    static auto readFrom(Q *port, char *buffer, const size_t count, int)
+        -> decltype(static_cast<size_t>(port->Q::read(buffer, count))) {
+        return static_cast<size_t>(port->Q::read(buffer, count));
+    }
+
+    template<typename Q>
+    static size_t readFrom(Q *port, char *buffer, const size_t count, long) {
+        for (size_t i = 0; i < count; i++)
+            buffer[i] = port->Q::read();
+
+        return count;
+    }
+};
+
+/**
+ * @brief A stand-in for the sensor's UART that answers every command with the same canned
+ *        reply, for benchmarks and tests of the protocol code without a sensor attached
+ *
+ * @details Works with either transport: `DFR_RadarStreamTransport` (through its virtual
+ *          methods) or `DFR_RadarPortTransport<DFR_RadarMemoryPort>` (inlined).
+ */
+class DFR_RadarMemoryPort : public Stream {
+public:
+    /**
+     * @param reply What the "sensor" sends back after each line written to it
+     */
+    explicit DFR_RadarMemoryPort(const char *reply)
+        : reply(reply), replyLength(strlen(reply)), position(replyLength), written(0) {}
+
+    int available() override { return replyLength - position; }
+    int read() override { return position < replyLength ? static_cast<uint8_t>(reply[position++]) : -1; }
+    int peek() override { return position < replyLength ? static_cast<uint8_t>(reply[position]) : -1; }
+
+    /**
+     * @brief Bulk read, as `DFR_RadarPortTransport` uses when a port has one
+     */
+    size_t read(char *buffer, size_t length) {
+        if (length > replyLength - position)
+            length = replyLength - position;
+
+        memcpy(buffer, reply + position, length);
+        position += length;
+        return length;
+    }
+
+    size_t write(uint8_t c) override {
+        written++;
+
+        // Every complete command gets the reply (again)
+        if (c == '\n')
+            position = 0;
+
+        return 1;
+    }
+
+    using Print::write;
+
+    /**
+     * @brief Get the number of bytes written to the "sensor" so far
+     */
+    size_t getWritten() const { return written; }
+
+    /**
+     * @brief Get the length of the canned reply
+     */
+    size_t getReplyLength() const { return replyLength; }
+
+private:
+    const char *reply;
+    size_t replyLength;
+    size_t position;
+    size_t written;
+};
+
+#endif